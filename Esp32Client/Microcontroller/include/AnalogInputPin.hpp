@@ -60,16 +60,19 @@ namespace IotZoo
                 float analogSignal = analogRead(pinAdc);
                 float voltage      = analogSignal * 3.3 / 4095.0;
 
-                Serial.print("Signal: ");
-                Serial.println(analogSignal);
-                Serial.print("Volt: ");
-                Serial.println(voltage, 3);
-                mqttClient->publish(getBaseTopic() + "/volt/" + String(deviceIndex), String(voltage, 3U));
+                logDebug("Signal: " << analogSignal << ", Volt: " << voltage);
+                mqttClient->publishState(getBaseTopic() + "/volt/" + String(deviceIndex), String(voltage, 3U));
 
                 lastLoopMillis = millis();
             }            
         }
 
+        unsigned long getLoopIntervalMs() const override
+        {
+            unsigned long elapsed = millis() - lastLoopMillis;
+            return elapsed > intervalMs ? 0 : intervalMs - elapsed + 1;
+        }
+
       protected:
         uint8_t       pinAdc;
         uint32_t      intervalMs;
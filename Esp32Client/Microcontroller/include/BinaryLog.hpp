@@ -0,0 +1,115 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Binary log: records the address of the format string and the raw arguments, formatting happens on the host.
+// --------------------------------------------------------------------------------------------------------------------
+#ifndef __BINARY_LOG_HPP__
+#define __BINARY_LOG_HPP__
+
+#include "DebugHelper.hpp"
+#include "Defines.hpp"
+
+#include <Arduino.h>
+#include <string.h>
+#include <type_traits>
+
+#ifdef USE_BINARY_LOG
+// printf like, e.g. logBinary("rpm %.0f, counter %u", rpm, counter). The format must be a string literal, it is not
+// copied: the record only holds its address, tools/decode_log.py reads the text from the firmware.elf. Arguments are
+// numbers of at most 32 bits or string literals (%s).
+#define logBinary(format, ...) IotZoo::binaryLog.write("" format, ##__VA_ARGS__)
+#elif LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define logBinary(format, ...) Serial.printf(format "\r\n", ##__VA_ARGS__)
+#else
+#define logBinary(format, ...)                                                                                                                       \
+    do                                                                                                                                               \
+    {                                                                                                                                                \
+    } while (0)
+#endif
+
+#ifdef USE_BINARY_LOG
+namespace IotZoo
+{
+    /// @brief Ring buffer of log records. Writing copies a few words under a spinlock and may be called from any task and
+    ///        from interrupts. A record is, in 32 bit little endian words:
+    ///        format address, millis, argument count << 24 | sequence number (24 bit), arguments.
+    ///        If the buffer is full, the record is dropped; the decoder sees the gap in the sequence numbers.
+    class BinaryLog
+    {
+      public:
+        static const uint8_t MaxArguments   = 6;
+        static const size_t  HeaderWords    = 3;
+        static const size_t  MaxRecordWords = HeaderWords + MaxArguments;
+
+        template <typename... Arguments>
+        void write(const char* format, Arguments... arguments)
+        {
+            static_assert(sizeof...(Arguments) <= MaxArguments, "logBinary: too many arguments");
+            const uint32_t words[] = {toWord(arguments)..., 0}; // the 0 avoids an empty array
+            append(format, words, sizeof...(Arguments));
+        }
+
+        /// @brief Moves the oldest record to record.
+        /// @return the number of words of the record, 0 if there is none.
+        size_t read(uint32_t* record);
+
+        /// @brief Moves as many whole records as fit into buffer.
+        /// @return the number of bytes written to buffer.
+        size_t read(uint8_t* buffer, size_t size);
+
+        uint32_t getDropped() const
+        {
+            return dropped;
+        }
+
+        /// @brief Starts a low priority task which writes the records to Serial, a line "#L <hex>" each.
+        void beginSerialOutput();
+
+      protected:
+        static const size_t        CapacityWords    = 1024; // 4 KiB, power of two
+        static const unsigned long OutputIntervalMs = 20;
+
+        template <typename T>
+        static uint32_t toWord(T value)
+        {
+            if constexpr (std::is_floating_point<T>::value)
+            {
+                float    number = value;
+                uint32_t word;
+                memcpy(&word, &number, sizeof(word));
+                return word;
+            }
+            else if constexpr (std::is_pointer<T>::value)
+            {
+                return reinterpret_cast<uintptr_t>(value);
+            }
+            else
+            {
+                static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "logBinary: only numbers and string literals");
+                static_assert(sizeof(T) <= sizeof(uint32_t), "logBinary: numbers of at most 32 bits");
+                return static_cast<uint32_t>(value);
+            }
+        }
+
+        void append(const char* format, const uint32_t* arguments, uint8_t count);
+
+        static void serialOutputTask(void* parameter);
+
+        uint32_t     ring[CapacityWords];
+        size_t       head     = 0; // next word to write
+        size_t       tail     = 0; // next word to read
+        uint32_t     sequence = 0;
+        uint32_t     dropped  = 0;
+        portMUX_TYPE lock     = portMUX_INITIALIZER_UNLOCKED;
+    };
+
+    extern BinaryLog binaryLog;
+} // namespace IotZoo
+#endif // USE_BINARY_LOG
+
+#endif // __BINARY_LOG_HPP__
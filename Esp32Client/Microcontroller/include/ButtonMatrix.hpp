@@ -90,6 +90,12 @@ namespace IotZoo
         char* keyMap = nullptr;
 
         Keypad* customKeypad;
+
+        String topicButtonPrefix; // baseTopic/button_matrix/<deviceIndex>/button/
+        String topicButton;       // reused, keeps its capacity
+
+        // Publishes state to topicButtonPrefix + key and millis() to topicButtonPrefix + key + subTopic.
+        void publishKeyState(char key, const char* state, const char* subTopic);
     };
 } // namespace IotZoo
 
@@ -36,6 +36,25 @@ namespace IotZoo
 
         long lastPublishedTemperatureMillis = millis();
 
+        struct Sensor
+        {
+            DeviceAddress address    = {};
+            bool          hasAddress = false;
+            float         celsius    = DEVICE_DISCONNECTED_C; // last reading
+            String        topicCelsius;
+        };
+
+        std::vector<Sensor> sensors; // in the order found on the bus
+
+        // The conversion runs in the sensors, the result is collected when conversionTimeMs has elapsed.
+        bool          converting            = false;
+        unsigned long conversionStartMillis = 0;
+        unsigned long conversionTimeMs      = 750;
+
+        void startConversion();
+
+        void collectTemperatures();
+
       public:
         // @param resolution resolution of a device to 9, 10, 11, or 12 bits.
         // @param transmissionIntervalMs Interval at which the temperatures are sent via MQTT.
@@ -50,7 +69,13 @@ namespace IotZoo
 
         virtual void loop() override;
 
-        std::vector<float> requestTemperatures();
+        unsigned long getLoopIntervalMs() const override;
+
+        /// @brief Last readings, one per sensor. DEVICE_DISCONNECTED_C if a sensor could not be read.
+        std::vector<float> getTemperatures() const;
+
+        /// @brief Last reading of the sensor with the ROM address, DEVICE_DISCONNECTED_C if unknown.
+        float getTemperature(const DeviceAddress address) const;
 
         /// @brief Sets the interval at which the temperature is sent
         /// @param interval in milliseconds
@@ -73,10 +98,6 @@ namespace IotZoo
         {
             lastPublishedTemperatureMillis = lastPublishedMillis;
         }
-
-        virtual bool setPayloadPropertyOfTopicLink(TopicLink& topicLink) override;
-
-        virtual void publishInternalMqtt() override;
     };
 } // namespace IotZoo
 #endif // __DS18B20_HPP__
@@ -13,22 +13,59 @@
 #pragma once
 #include "Defines.hpp"
 
+// Log levels. A message is compiled in only if its level is less or equal LOG_LEVEL. The arguments of a disabled message
+// are not even evaluated, so it costs neither flash nor time, no String is built and nothing is written to the UART.
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1 // something failed
+#define LOG_LEVEL_INFO  2 // startup, configuration, connection and state changes
+#define LOG_LEVEL_DEBUG 3 // details, e.g. every publish and every sample in the loop
+
+#ifndef LOG_LEVEL // set it in the build_flags, e.g. -DLOG_LEVEL=LOG_LEVEL_ERROR for a release build
 #ifdef USE_DEBUG_MESSAGES
+#define LOG_LEVEL LOG_LEVEL_INFO
+#else
+#define LOG_LEVEL LOG_LEVEL_NONE
+#endif
+#endif // LOG_LEVEL
+
+#if LOG_LEVEL > LOG_LEVEL_NONE
 #include <TinyConsole.h>
 #include <TinyStreaming.h>
+#endif
 
 struct DebugHelper
 {
-    static const int debugLevel = 2; // 0: no debug messages, 1: only important messages, 2: all messages
-}; 
+    static const int debugLevel = LOG_LEVEL; // 0: no debug messages, 1: only errors, 2: important messages, 3: all messages
+};
 
-#define debug(what)                                                                                                                                  \
+// Usage: logInfo("Connected to " << ip); prefer << over String concatenation, it does not allocate.
+#define LOG_WRITE(what)                                                                                                                              \
+    do                                                                                                                                               \
     {                                                                                                                                                \
-        if (DebugHelper::debugLevel >= 1)                                                                                                                    \
-            Console << __FILE__ << " L" << (int)__LINE__ << ' ' << what << _EndLineCode::endl;                                                                           \
-    }
-#else
-#define debug(what)                                                                                                                                  \
+        Console << __FILE__ << " L" << (int)__LINE__ << ' ' << what << _EndLineCode::endl;                                                           \
+    } while (0)
+
+#define LOG_NOTHING()                                                                                                                                \
+    do                                                                                                                                               \
     {                                                                                                                                                \
-    }
-#endif // USE_DEBUG_MESSAGES
\ No newline at end of file
+    } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define logError(what) LOG_WRITE(what)
+#else
+#define logError(what) LOG_NOTHING()
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define logInfo(what) LOG_WRITE(what)
+#else
+#define logInfo(what) LOG_NOTHING()
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define logDebug(what) LOG_WRITE(what)
+#else
+#define logDebug(what) LOG_NOTHING()
+#endif
+
+#define debug(what) logInfo(what)
@@ -29,6 +29,17 @@ namespace IotZoo
 // such as controlling a fan or display the value.
 #define USE_INTERNAL_MQTT
 
+// Runs the MQTT client and the REST server in a task on core 0 and the devices in loop() on core 1, so a slow MQTT reconnect
+// does not stall displays and sensors. Publishes and received messages are passed between the cores by queues, see MqttClient.
+// The internal MQTT broker stays with the devices because its local clients call it directly.
+// #define USE_DUAL_CORE
+
+// logBinary() stores the address of the format string and the raw arguments in a RAM ring buffer instead of formatting
+// text in the calling task. A low priority task writes the records to Serial, tools/decode_log.py formats them on the PC
+// with the firmware.elf. With BINARY_LOG_TO_MQTT the records are published to <base topic>/log once a second instead.
+// #define USE_BINARY_LOG
+// #define BINARY_LOG_TO_MQTT
+
 
 
     // --------------------------------------------------------------------------------------------------------------------
@@ -45,6 +56,7 @@ namespace IotZoo
     // #define USE_WS2818      // NeoPixel | Default Pins: DIN: 22
     // #ifdef USE_WS2818
     // #define USE_WS2818_PIXEL_MATRIX
+    // #define USE_WS2818_RMT // sends the pixels with the RMT peripheral in the background, the interrupts stay enabled
     // #endif
 
     // #define USE_AUDIO_STREAMER // INMP441 microphone Default Pins: I2S_WS: 22, I2S_SCK: 15, I2S_SD: 35
@@ -56,6 +68,7 @@ namespace IotZoo
     //  #define USE_STEPPER_MOTOR
 
 #define USE_KY025 // Reed Contact, Default Pin: 19
+// #define USE_KY025_PCNT // KY025 counts with the hardware pulse counter instead of an interrupt, for higher speeds
 // #define USE_HB0014            // Hitchi IR ttl
 // #define USE_HW040 // Rotary Encoder, Default Pins: CLK: 32, DT: 21, MS: 33
 
@@ -73,6 +86,10 @@ namespace IotZoo
 
 // #define ERASE_FLASH
 
+#if defined(BINARY_LOG_TO_MQTT) && (!defined(USE_BINARY_LOG) || !defined(USE_MQTT))
+#error "BINARY_LOG_TO_MQTT needs USE_BINARY_LOG and USE_MQTT."
+#endif
+
 #endif // __DEFINES_HPP__
 
 // --------------------------------------------------------------------------------------------------------------------
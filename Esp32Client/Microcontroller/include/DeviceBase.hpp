@@ -12,6 +12,7 @@
 #ifndef __DEVICE_BASE_HPP__
 #define __DEVICE_BASE_HPP__
 
+#include "DebugHelper.hpp"
 #include "Defines.hpp"
 #ifdef USE_MQTT
 #include "MqttClient.hpp"
@@ -20,6 +21,7 @@
 #include "MqttClient2.hpp"
 #endif
 #include "./pocos/Topic.hpp"
+#include "Scheduler.hpp"
 
 #include <ArduinoJson.h>
 #ifdef ARDUINO_ESP32_DEV
@@ -58,94 +60,54 @@ namespace IotZoo
             internalMqttClient = client;
         }
 
-        // true: topicLink.Expression is empty or evaluates to true.
-        bool EvaluateExpression(const TopicLink& topicLink)
+        // true: topicLink.Expression is empty or evaluates to true for value.
+        bool EvaluateExpression(const TopicLink& topicLink, const String& value)
         {
-            bool doIt = false;
-            debug("EvaluateExpression. topicLink.Expression: " + topicLink.Expression +
-                  ", Expression length: " + String(topicLink.Expression.length()) + ", topicLink.Payload: " + topicLink.Payload);
+            // The expression is compiled once when the TopicLink is created.
+            bool doIt = topicLink.Condition.evaluate(value);
+            logDebug("EvaluateExpression. topicLink.Expression: " + topicLink.Expression + ", value: " + value + ", -> doIt: " + String(doIt));
+            return doIt;
+        }
 
-            if (topicLink.Expression == nullptr || topicLink.Expression.length() == 0 || topicLink.Expression.equalsIgnoreCase("null"))
+        /// @brief Call this when the value of topic has changed. Only the TopicLinks triggered by topic are evaluated, matching
+        ///        ones are published via internal MQTT unless the change is within their Deadband. A value arriving within
+        ///        MinIntervalMs is kept, only the latest one, and published by loop() once MinIntervalMs has passed.
+        /// @param topic e.g. "iotzoo/esp32/reed_contact/0/rpm"
+        /// @param value the new value, e.g. "44"
+        void signalValueChanged(const String& topic, const String& value)
+        {
+            if (nullptr == internalMqttClient)
             {
-                doIt = true; // no expression means "always publish"
+                return;
             }
-            else
+            unsigned long now = millis();
+            for (auto& topicLink : TopicLinks)
             {
-                StaticJsonDocument<256> jsonDocument;
-
-                if (!deserializeStaticJsonAndPublishError(jsonDocument, topicLink.Expression))
-                {
-                    return false;
-                }
-
-                String strOperator    = jsonDocument["Operator"].as<String>();
-                double referenceValue = jsonDocument["Value"].as<double>();
-                if (strOperator == ">")
-                {
-                    if (topicLink.Payload.toDouble() > referenceValue)
-                    {
-                        doIt = true;
-                    }
-                }
-                else if (strOperator == "<" || strOperator == "<=" || strOperator == ">=")
+                if (!topicLink.TriggeringTopic.equalsIgnoreCase(topic))
                 {
-                    if (topicLink.Payload.toDouble() < referenceValue)
-                    {
-                        doIt = true;
-                    }
+                    continue;
                 }
-                else if (strOperator == "<=")
+                if (!EvaluateExpression(topicLink, value))
                 {
-                    if (topicLink.Payload.toDouble() <= referenceValue)
-                    {
-                        doIt = true;
-                    }
+                    topicLink.LastValue  = String(); // the next value that is true fires regardless of the Deadband
+                    topicLink.HasPending = false;
+                    continue;
                 }
-                else if (strOperator == ">=")
+                if (!isOutsideDeadband(topicLink, value))
                 {
-                    if (topicLink.Payload.toDouble() >= referenceValue)
-                    {
-                        doIt = true;
-                    }
+                    logDebug("DeviceBase::signalValueChanged. Suppressed " + topicLink.TargetTopic + ", value: " + value);
+                    topicLink.HasPending = false; // back at the published value
+                    continue;
                 }
-                else if (strOperator == "==")
+                if (topicLink.HasFired && topicLink.MinIntervalMs > 0 && now - topicLink.LastFiredMillis < topicLink.MinIntervalMs)
                 {
-                    if (referenceValue == topicLink.Payload.toDouble())
-                    {
-                        doIt = true;
-                    }
+                    logDebug("DeviceBase::signalValueChanged. Deferred " + topicLink.TargetTopic + ", value: " + value);
+                    topicLink.PendingValue = value;
+                    topicLink.HasPending   = true;
+                    continue;
                 }
-                debug("Payload: " + topicLink.Payload + " " + "Expression operator: " + strOperator + " value: " + referenceValue +
-                      ", -> doIt: " + String(doIt));
-            }
-            return doIt;
-        }
-
-        // Override this method to set the topicLink.Payload based on the current device data. This is needed if topicLink.TargetPayload is "input" or
-        // empty. topicLink.Payload will be send via internal MQTT.
-        // Return true if topicLink.Payload has been set, false otherwise.
-        virtual bool setPayloadPropertyOfTopicLink(TopicLink& topicLink)
-        {
-            debug("DeviceBase::setPayloadPropertyOfTopicLink. topicLink.TriggeringTopic: " + topicLink.TriggeringTopic +
-                  ", topicLink.Expression: " + topicLink.Expression + ", topicLink.TargetTopic: " + topicLink.TargetTopic +
-                  ", topicLink.TargetPayload: " + topicLink.TargetPayload);
-            topicLink.TargetPayload.trim();
-            if (topicLink.TargetPayload.length() && !topicLink.TargetPayload.equalsIgnoreCase("input") &&
-                !topicLink.TargetPayload.equalsIgnoreCase("null"))
-            {
-                topicLink.Payload =
-                    topicLink.TargetPayload; // default to configured TargetPayload if TriggeringTopic does not match any known topic.)
-                debug("Using TargetTopic: " + topicLink.TargetTopic + " as Payload: " + topicLink.Payload + "length: (" + topicLink.Payload.length() +
-                      ")");
-                return true;
+                fireTopicLink(topicLink, value, now);
             }
-
-            if (topicLink.TargetTopic.length() == 0)
-            {
-                debug("⚠️ Warning: TargetTopic is empty! This means that the received TriggeringTopic message will not be published to any topic.");
-            }
-
-            return false;
         }
 
         void setEnableServerDownText(bool enable)
@@ -162,39 +124,6 @@ namespace IotZoo
             return enableServerDownText;
         }
 
-        virtual void publishInternalMqtt()
-        {
-            debug("DeviceBase::publishInternalMqtt. Count of TopicLinks: " + String(TopicLinks.size()));
-
-            if (nullptr != internalMqttClient)
-            {
-                // Has an internal component interest on the triggering topic?
-                for (auto& topicLink : TopicLinks)
-                {
-                    // Should the event take place?
-                    bool doPublish = false;
-
-                    if (topicLink.Expression.length() == 0)
-                    {
-                        doPublish = true; // no expression means "always publish"
-                    }
-                    if (!setPayloadPropertyOfTopicLink(topicLink))
-                    {
-                        debug("OfTopiDeviceBase::publishInternalMqtt. setPayloadPropertycLink did not set topicLink.Payload! "
-                              "topicLink.TriggeringTopic: " +
-                              topicLink.TriggeringTopic + ", topicLink.Expression: " + topicLink.Expression +
-                              ", topicLink.TargetTopic: " + topicLink.TargetTopic);
-                    }
-                    doPublish = EvaluateExpression(topicLink);
-
-                    if (doPublish)
-                    {
-                        internalMqttClient->publish(topicLink);
-                    }
-                }
-            }
-        }
-
 #endif // USE_INTERNAL_MQTT
         int getDeviceIndex() const
         {
@@ -206,12 +135,34 @@ namespace IotZoo
 #ifdef USE_INTERNAL_MQTT
             if (nullptr != internalMqttClient)
             {
-                publishInternalMqtt();
                 internalMqttClient->loop();
+                publishPendingTopicLinks();
             }
 #endif // USE_INTERNAL_MQTT
         }
 
+        /// @brief Milliseconds until loop() wants to be called again. Override to declare the cadence of the device.
+        virtual unsigned long getLoopIntervalMs() const
+        {
+            return 5;
+        }
+
+        /// @brief Called by Scheduler::addDevice().
+        void setSchedulerTask(Scheduler* const scheduler, Scheduler::TaskId taskId)
+        {
+            this->scheduler       = scheduler;
+            this->schedulerTaskId = taskId;
+        }
+
+        /// @brief Lets the scheduler call loop() as soon as possible, e.g. when new data has arrived.
+        void requestLoop()
+        {
+            if (nullptr != scheduler)
+            {
+                scheduler->trigger(schedulerTaskId);
+            }
+        }
+
         /// @brief Let the user know what the device can do.
         /// @param topics
         virtual void addMqttTopicsToRegister(std::vector<Topic>* const topics) const
@@ -246,7 +197,7 @@ namespace IotZoo
             Serial.println("do override onIotZooClientUnavailable!");
         }
 
-        String getBaseTopic() const
+        const String& getBaseTopic() const
         {
             return baseTopic;
         }
@@ -266,6 +217,11 @@ namespace IotZoo
             return mqttClient;
         }
 
+        Settings* getSettings() const
+        {
+            return settings;
+        }
+
         void publishError(const String& errMsg)
         {
             String topic = getBaseTopic() + "/error";
@@ -323,9 +279,65 @@ namespace IotZoo
         bool        mqttCallbacksAreRegistered = false;
         bool        enableServerDownText       = true;
 
+        Scheduler*        scheduler       = nullptr;
+        Scheduler::TaskId schedulerTaskId = 0;
+
 #ifdef USE_INTERNAL_MQTT
         InternalMqttClient* internalMqttClient = nullptr;
         vector<TopicLink>   TopicLinks;
+
+        // The configured TargetPayload, or value if TargetPayload is empty or "input".
+        static void setPayloadOfTopicLink(TopicLink& topicLink, const String& value)
+        {
+            if (topicLink.TargetPayload.length() && !topicLink.TargetPayload.equalsIgnoreCase("input") &&
+                !topicLink.TargetPayload.equalsIgnoreCase("null"))
+            {
+                topicLink.Payload = topicLink.TargetPayload;
+            }
+            else
+            {
+                topicLink.Payload = value;
+            }
+        }
+
+        void fireTopicLink(TopicLink& topicLink, const String& value, unsigned long now)
+        {
+            setPayloadOfTopicLink(topicLink, value);
+            topicLink.HasFired        = true;
+            topicLink.LastValue       = value;
+            topicLink.LastFiredMillis = now;
+            topicLink.HasPending      = false;
+            topicLink.PendingValue    = String();
+            internalMqttClient->publish(topicLink);
+        }
+
+        // Publishes the values deferred by signalValueChanged() whose MinIntervalMs has passed.
+        void publishPendingTopicLinks()
+        {
+            unsigned long now = millis();
+            for (auto& topicLink : TopicLinks)
+            {
+                if (topicLink.HasPending && now - topicLink.LastFiredMillis >= topicLink.MinIntervalMs)
+                {
+                    String value = topicLink.PendingValue;
+                    fireTopicLink(topicLink, value, now);
+                }
+            }
+        }
+
+        // Numeric values have to change by more than Deadband, text values have to differ.
+        static bool isOutsideDeadband(const TopicLink& topicLink, const String& value)
+        {
+            if (topicLink.LastValue.length() == 0)
+            {
+                return true;
+            }
+            if (value == topicLink.LastValue)
+            {
+                return false;
+            }
+            return topicLink.Deadband <= 0 || fabs(value.toDouble() - topicLink.LastValue.toDouble()) > topicLink.Deadband;
+        }
 #endif
     };
 
@@ -17,11 +17,42 @@
 #include "DeviceBase.hpp"
 #include "DeviceExtension.hpp"
 
+#include <ArduinoJson.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 namespace IotZoo
 {
+    struct AlarmZoneSpan
+    {
+        uint16_t StartIndex = 0;
+        uint16_t Length     = 0;
+    };
+
+    struct AlarmColor
+    {
+        uint32_t Color      = 0;
+        uint8_t  Brightness = 4;
+        uint16_t Priority   = 0; // position in the colors table, the lowest of the subject wins
+    };
+
+    /// @brief Lights up zones of a pixel matrix on alarms. The subject of an alarm is free text, e.g. "Person Dachboden". Its
+    ///        words are looked up in two tables: one word names the color (a color or what was detected), another one the
+    ///        zone. If several words name a color, the one listed first in the colors table wins, whatever the order of
+    ///        the words: the built-in table lists the explicit colors before the detections, so "Person Dachboden orange"
+    ///        is orange with brightness 4. Of the zones, the first word counts.
+    ///        The tables are read from the settings key "alarm_zones" at startup (save it with settings/save and
+    ///        restart), without it the built-in layouts for 8x8 and 16x16 matrices are used:
+    ///        {"millisUntilTurnOff": 60000,
+    ///         "colors": [{"name": "person", "color": "#FF0000", "brightness": 16}, ...],
+    ///         "zones":  [{"name": "dachboden", "spans": [[27, 3], [34, 3]]}, ...]}
+    ///        spans are [first pixel, number of pixels]. The zone "all" is the whole matrix unless it is defined.
     class AlarmZonesDeviceExtension : public DeviceExtension
     {
       public:
+        static constexpr const char* SettingsKey = "alarm_zones";
+
         AlarmZonesDeviceExtension(DeviceBase* const deviceBase);
 
         void onMqttConnectionEstablished();
@@ -31,11 +62,20 @@ namespace IotZoo
         void addMqttTopicsToRegister(std::vector<Topic>* const topics) const;
 
       protected:
-        uint getAlarmLevel(const String& subject);
+        /// @brief Builds the tables from the settings, or from the built-in layout for the size of the matrix.
+        void loadTables();
+
+        void loadColors(JsonArrayConst elements);
+
+        void loadZones(JsonArrayConst elements, uint16_t numberOfLeds);
 
         void onAlarmReceived(const String& subject);
+
+        std::unordered_map<std::string, AlarmColor>                 colors;
+        std::unordered_map<std::string, std::vector<AlarmZoneSpan>> zones;
+        unsigned long                                               millisUntilTurnOff = 60000;
     };
 } // namespace IotZoo
 
 #endif // USE_WS2818
-#endif // USE_WS2818_PIXEL_MATRIX
\ No newline at end of file
+#endif // USE_WS2818_PIXEL_MATRIX
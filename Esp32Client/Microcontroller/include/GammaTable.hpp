@@ -0,0 +1,50 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Gamma correction for LEDs, computed by the compiler.
+// --------------------------------------------------------------------------------------------------------------------
+#ifndef __GAMMA_TABLE_HPP__
+#define __GAMMA_TABLE_HPP__
+
+#include <array>
+#include <stdint.h>
+
+namespace IotZoo
+{
+    /// @brief Square root by Newton's method, usable in constant expressions.
+    constexpr double constexprSqrt(double x)
+    {
+        double root = x > 1 ? x : 1;
+        for (uint8_t i = 0; i < 32; i++)
+        {
+            root = (root + x / root) / 2;
+        }
+        return root;
+    }
+
+    /// @brief 255 * (value / 255)^2.5, rounded.
+    constexpr std::array<uint8_t, 256> makeGammaTable()
+    {
+        std::array<uint8_t, 256> table{};
+        for (uint16_t value = 0; value < 256; value++)
+        {
+            double x     = value / 255.0;
+            table[value] = (uint8_t)(255 * x * x * constexprSqrt(x) + 0.5);
+        }
+        return table;
+    }
+
+    /// @brief Maps a color channel to the LED duty cycle that looks linear to the eye. The LED is linear, the eye is not:
+    ///        without the correction, dark colors are too bright and mixed colors look washed out. Built at compile time,
+    ///        the table stays in flash.
+    inline constexpr std::array<uint8_t, 256> GammaTable = makeGammaTable();
+
+    static_assert(GammaTable[0] == 0 && GammaTable[255] == 255, "gamma table must keep black and white");
+} // namespace IotZoo
+
+#endif // __GAMMA_TABLE_HPP__
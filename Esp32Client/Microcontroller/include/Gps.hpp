@@ -18,22 +18,54 @@
 #include "DeviceBase.hpp"
 #include "TinyGPSPlus.h"
 
-#include <SoftwareSerial.h>
+#include <atomic>
+#include <mutex>
 
 namespace IotZoo
 {
+    /// @brief GPS receiver on the hardware UART Serial2. NMEA data is parsed in the uart event task as soon as it arrives,
+    ///        loop() only publishes a new valid fix, at most every publishIntervalMs.
     class Gps : public DeviceBase
     {
       protected:
+        struct Fix
+        {
+            double   lat         = 0;
+            double   lng         = 0;
+            double   alt         = 0;
+            bool     hasDateTime = false;
+            uint16_t year        = 0;
+            uint8_t  month       = 0;
+            uint8_t  day         = 0;
+            uint8_t  hour        = 0;
+            uint8_t  minute      = 0;
+            uint8_t  second      = 0;
+        };
+
         uint8_t pinRx;
         uint8_t pinTx;
 
-        TinyGPSPlus     gps;
-        SoftwareSerial* softwareSerial;
+        HardwareSerial* serial = &Serial2; // Serial1 is used by the Rd03D
+        TinyGPSPlus     gps;               // used by the uart event task only
+        String          topicPosition;
+
+        std::mutex            fixLock;
+        Fix                   fix;                   // last valid fix, guarded by fixLock
+        uint32_t              fixCount          = 0; // guarded by fixLock
+        uint32_t              publishedFixCount = 0;
+        std::atomic<uint32_t> bytesReceived{0};
+
+        unsigned long publishIntervalMs;
+        unsigned long lastPublishMillis = 0;
+        bool          noDataReported    = false;
+
+        void onReceive();
+
+        String makePayload(const Fix& fix) const;
 
       public:
         Gps(int deviceIndex, Settings* const settings, MqttClient* const mqttClient, const String& baseTopic,
-          uint8_t pinRx, uint8_t pinTx, uint32_t baud = 9600);
+          uint8_t pinRx, uint8_t pinTx, uint32_t baud = 9600, unsigned long publishIntervalMs = 1000);
         ~Gps() override;
 
         /// @brief Let the user know what the device can do.
@@ -42,7 +74,13 @@ namespace IotZoo
 
         void loop() override;
 
-        void smartDelay(unsigned long ms);
+        unsigned long getLoopIntervalMs() const override
+        {
+            return publishIntervalMs; // a new fix requests an earlier loop()
+        }
+
+        /// @brief Feeds NMEA data to the parser and stores a new valid fix. Called by the uart event task.
+        void encode(const uint8_t* data, size_t length);
     };
 } // namespace IotZoo
 
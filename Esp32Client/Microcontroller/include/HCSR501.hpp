@@ -51,6 +51,7 @@ namespace IotZoo
     unsigned long lastMillisMotionDetectorRising = millis();
     unsigned long motionDetectorCounterRising = 0;
     unsigned long oldMotionDetectorCounterRising = lastMillisMotionDetectorRising;
+    String topicMotionDetectorTriggered;
   };
 }
 
@@ -29,6 +29,12 @@ namespace IotZoo
 
         void loop() override;
 
+        unsigned long getLoopIntervalMs() const override
+        {
+            unsigned long elapsed = millis() - lastMillis;
+            return elapsed > intervalMs ? 0 : intervalMs - elapsed + 1;
+        }
+
         String getHumiditySensorType() const
         {
             String strDeviceType = "dht11";
@@ -52,6 +58,7 @@ namespace IotZoo
         uint8_t deviceType = DHT11;
         ulong lastMillis = millis();
         ulong intervalMs = 10000;
+        String topicHumidity;
     };
 } // namespace IotZoo
 
@@ -0,0 +1,100 @@
+#pragma once
+#include "Defines.hpp"
+
+#ifdef USE_INTERNAL_MQTT
+
+#include <AsyncTCP.h>
+#include <Client.h>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+struct pbuf;
+
+/***
+ * Arduino Client on top of a connection accepted by the AsyncServer of InternalMqttBroker.
+ *
+ * AsyncTCP calls back from its own task. Received packets are queued as they are and
+ * read by InternalMqttClient::loop(), a packet is acknowledged once it is read. So the
+ * tcp window throttles a sender faster than loop() instead of a buffer overflowing.
+ * Data that does not fit into the tcp send buffer is kept and sent when the peer
+ * acknowledges. The AsyncClient is deleted in its disconnect callback, the shared
+ * State keeps the buffers alive for both sides.
+ */
+class AsyncTcpClient : public Client
+{
+  public:
+    static const size_t MaxTxPending = 16384; // slower readers are disconnected
+
+    explicit AsyncTcpClient(AsyncClient* client);
+
+    ~AsyncTcpClient() override;
+
+    // Only accepted connections, an AsyncTcpClient never connects itself.
+    int connect(IPAddress ip, uint16_t port) override
+    {
+        return 0;
+    }
+
+    int connect(const char* host, uint16_t port) override
+    {
+        return 0;
+    }
+
+    size_t write(uint8_t byte) override
+    {
+        return write(&byte, 1);
+    }
+
+    size_t write(const uint8_t* buf, size_t size) override;
+
+    int available() override;
+
+    int read() override;
+
+    int read(uint8_t* buf, size_t size) override;
+
+    int peek() override;
+
+    void flush() override
+    {
+    }
+
+    void stop() override;
+
+    // Like WiFiClient: still connected while received data is unread.
+    uint8_t connected() override;
+
+    operator bool() override
+    {
+        return connected();
+    }
+
+  private:
+    struct State
+    {
+        std::recursive_mutex lock;
+        AsyncClient*         client = nullptr; // nullptr once disconnected
+        std::deque<pbuf*>    rxPackets;
+        size_t               rxOffset = 0; // already read from rxPackets.front()
+        size_t               rxSize   = 0; // unread bytes in rxPackets
+        std::string          txPending;
+        bool                 overflow = false;
+
+        void release(pbuf* packet);
+        void clearReceived();
+    };
+
+    using StatePtr = std::shared_ptr<State>;
+
+    static void onPacket(void* arg, AsyncClient* client, pbuf* packet);
+    static void onAck(void* arg, AsyncClient* client, size_t len, uint32_t time);
+    static void onDisconnect(void* arg, AsyncClient* client);
+
+    static size_t send(State& state, const char* data, size_t length);
+
+    StatePtr state;
+};
+
+#endif // USE_INTERNAL_MQTT
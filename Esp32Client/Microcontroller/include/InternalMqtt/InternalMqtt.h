@@ -6,25 +6,32 @@
 #include "DebugHelper.hpp"
 #include <WiFi.h>
 
-#define dbg_ptr uint32_t
+#define dbg_ptr uintptr_t
 
+#include "RingBuffer.h"
 #include "StringIndexer.h"
+#include "TopicTrie.h"
 #include "pocos/TopicLink.hpp"
 
 #include <TinyStreaming.h>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
 
+class AsyncClient;
+class AsyncServer;
 
-using TcpClient = WiFiClient;
-using TcpServer = WiFiServer;
+// WiFiClient for the connection to a parent broker, AsyncTcpClient for accepted connections.
+using TcpClient = Client;
+using TcpServer = AsyncServer;
 
 enum InternalMqttError : uint8_t
 {
     MqttOk             = 0,
     MqttNowhereToSend  = 1,
     MqttInvalidMessage = 2,
+    MqttTooManyTopics  = 3, // StringIndexer out of capacity
 };
 
 using string = TinyConsole::string;
@@ -36,7 +43,7 @@ class InternalTopic : public IndexedString
     {
     }
 
-    InternalTopic(const char* s, uint8_t len) : IndexedString(s, len)
+    InternalTopic(const char* s, uint16_t len) : IndexedString(s, len)
     {
     }
     
@@ -103,9 +110,22 @@ class MqttMessage
 
     void incoming(char byte);
 
+    // Parses received bytes up to the end of the current message,
+    // returns the number of bytes used. The body is copied in one block.
+    size_t incoming(const char* p, size_t length);
+
+    // After an overflow (state Error) the message stays empty, every add() is ignored and sendTo() sends nothing.
     void add(char byte)
     {
-        incoming(byte);
+        if (state == Create)
+        {
+            buffer += byte;
+            size++;
+        }
+        else if (state != Error)
+        {
+            incoming(byte);
+        }
     }
 
     void add(const char* p, size_t len, bool addLength = true);
@@ -144,17 +164,30 @@ class MqttMessage
         return state == Complete ? static_cast<Type>(buffer[0] & 0xF0) : Unknown;
     }
 
+    // Also true for a complete message of an unknown type (0), which has to be handled too.
+    bool isComplete() const
+    {
+        return state == Complete;
+    }
+
     uint8_t flags() const
     {
         return static_cast<uint8_t>(buffer[0] & 0x0F);
     }
 
-    void create(Type type)
+    // Builder mode. expected_length is the length of variable header + payload if known,
+    // so the buffer is allocated once and short messages need only one length byte.
+    void create(Type type, size_t expected_length = 0)
     {
+        buffer.clear();
+        buffer.reserve(3 + expected_length);
         buffer = (decltype(buffer)::value_type)type;
         buffer += '\0'; // reserved for msg length byte 1/2
-        buffer += '\0'; // reserved for msg length byte 2/2 (fixed)
-        vheader = 3;    // Should never change
+        if (expected_length == 0 or expected_length > 0x7F)
+        {
+            buffer += '\0'; // reserved for msg length byte 2/2
+        }
+        vheader = buffer.length();
         size    = 0;
         state   = Create;
     }
@@ -195,6 +228,7 @@ class InternalMqttClient
     };
 
   public:
+    // payload is only valid during the call and is not necessarily null terminated, use payload_length.
     using CallBack = void (*)(const InternalMqttClient* source, const InternalTopic& topic, const char* payload, size_t payload_length);
 
     /** Constructor. Broker is the adress of a local broker if not null
@@ -285,7 +319,7 @@ class InternalMqttClient
     void dump(string indent = "")
     {
         (void)indent;
-#if USE_DEBUG_MESSAGES
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
         uint32_t ms = millis();
         Console << indent << "+-- " << '\'' << clientId.c_str() << "' " << (connected() ? " ON " : " OFF");
         Console << ", alive=" << alive << '/' << ms << ", ka=" << keep_alive << ' ';
@@ -346,9 +380,15 @@ class InternalMqttClient
     InternalMqttClient(InternalMqttBroker* local_broker, TcpClient* client);
     // republish a received publish if topic matches any in subscriptions
     InternalMqttError publishIfSubscribed(const InternalTopic& topic, MqttMessage& msg);
+    // republish a received publish, the broker already knows that topic matches
+    InternalMqttError deliver(const InternalTopic& topic, MqttMessage& msg);
+    // in process delivery to a local client, no MqttMessage involved
+    void deliver(const InternalTopic& topic, const char* payload, size_t length);
 
     void clientAlive(uint32_t more_seconds);
     void processMessage(MqttMessage* message);
+    // parses rxBuffer, processes each completed message
+    void processReceived();
 
     uint8_t     cltFlags = CltFlagNone;
     char        mqtt_flags;
@@ -356,6 +396,8 @@ class InternalMqttClient
     uint32_t    alive;
     MqttMessage message;
 
+    RingBuffer<256> rxBuffer; // bytes read from tcpClient, not yet parsed
+
     // connection to local broker, or link to the parent
     // when MqttBroker uses MqttClient for each external connection
     InternalMqttBroker* localBroker = nullptr;
@@ -380,6 +422,9 @@ class InternalMqttBroker
 
     ~InternalMqttBroker();
 
+    // Starts listening on port, WiFi must be started before.
+    void begin();
+
     void loop();
 
     // Connect the broker to a parent broker.
@@ -412,9 +457,18 @@ class InternalMqttBroker
 
     static void onClient(void*, TcpClient*);
 
-    InternalMqttError publish(const InternalMqttClient* source, const InternalTopic& topic, MqttMessage& msg) const;
+    // AsyncTCP task, the connection is adopted by the next loop()
+    static void onAccept(void* broker_ptr, AsyncClient* client);
+
+    InternalMqttError publish(const InternalMqttClient* source, const InternalTopic& topic, MqttMessage& msg);
 
-    InternalMqttError subscribe(const InternalTopic& topic, uint8_t qos);
+    // Local clients get topic and payload as they are, the publish message is only
+    // encoded if a tcp client (or the parent broker) has to receive it.
+    InternalMqttError publish(const InternalMqttClient* source, const InternalTopic& topic, const char* payload, size_t length);
+
+    InternalMqttError subscribe(InternalMqttClient* client, const InternalTopic& topic, uint8_t qos);
+
+    void unsubscribe(InternalMqttClient* client, const InternalTopic& topic);
 
     // For clients that are added not by the broker itself (local clients)
     void addClient(InternalMqttClient* client);
@@ -423,10 +477,18 @@ class InternalMqttBroker
     bool compareString(const char* good, const char* str, uint8_t str_len) const;
     std::vector<InternalMqttClient*> clients;
 
+    // subscriptions of all clients, one walk per publish
+    TopicTrie<InternalMqttClient*> subscriptions;
+
   private:
 
     InternalMqttClient* remoteBroker = nullptr;
 
+    uint16_t                port;
+    TcpServer*              server = nullptr;
+    std::mutex              acceptedLock;
+    std::vector<TcpClient*> accepted; // accepted by the server, not yet in clients
+
     State state = Disconnected;
 };
 
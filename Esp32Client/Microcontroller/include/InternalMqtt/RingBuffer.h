@@ -0,0 +1,102 @@
+#pragma once
+#include "Defines.hpp"
+
+#ifdef USE_INTERNAL_MQTT
+
+#include <cstddef>
+#include <cstring>
+
+/***
+ * Fixed size byte ring used as receive buffer of a mqtt connection.
+ *
+ * The producer asks for the contiguous free area (writable), fills it (e.g. with
+ * TcpClient::read(buf, n)) and commits the number of bytes written. The consumer
+ * gets the contiguous readable area (readable) and consumes what it has parsed.
+ * Capacity must be a power of two.
+ */
+template <size_t Capacity>
+class RingBuffer
+{
+    static_assert(Capacity and (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+  public:
+    size_t size() const
+    {
+        return head - tail;
+    }
+
+    size_t space() const
+    {
+        return Capacity - size();
+    }
+
+    bool empty() const
+    {
+        return head == tail;
+    }
+
+    // Contiguous free area starting at the write position.
+    char* writable(size_t& length)
+    {
+        size_t start = head & (Capacity - 1);
+        length       = Capacity - start;
+        if (length > space())
+        {
+            length = space();
+        }
+        return data + start;
+    }
+
+    void commit(size_t length)
+    {
+        head += length;
+    }
+
+    // Copies as much of p as fits, returns the number of bytes stored.
+    size_t write(const char* p, size_t length)
+    {
+        size_t stored = 0;
+        while (stored < length and space())
+        {
+            size_t room;
+            char*  dest = writable(room);
+            if (room > length - stored)
+            {
+                room = length - stored;
+            }
+            memcpy(dest, p + stored, room);
+            commit(room);
+            stored += room;
+        }
+        return stored;
+    }
+
+    // Contiguous readable area starting at the read position.
+    const char* readable(size_t& length) const
+    {
+        size_t start = tail & (Capacity - 1);
+        length       = Capacity - start;
+        if (length > size())
+        {
+            length = size();
+        }
+        return data + start;
+    }
+
+    void consume(size_t length)
+    {
+        tail += length;
+    }
+
+    void clear()
+    {
+        head = tail = 0;
+    }
+
+  private:
+    char   data[Capacity];
+    size_t head = 0; // free running write position
+    size_t tail = 0; // free running read position
+};
+
+#endif // USE_INTERNAL_MQTT
@@ -5,95 +5,138 @@
 
 #include <TinyConsole.h>
 #include <assert.h>
-#include <map>
+#include <deque>
 #include <string.h>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 using string = TinyConsole::string;
 
 /***
- * Allows to store up to 255 different strings with one byte class
- * very memory efficient when one string is used many times.
+ * Interns strings (topics) used many times, each distinct string is stored once
+ * and referenced by a 16 bit index. Lookup is hashed (O(1)), index 0 means "no string".
  */
 class StringIndexer
 {
   private:
     class StringCounter
     {
-        string  str;
-        uint8_t used = 0;
+        string   str;
+        uint16_t used = 0;
         friend class StringIndexer;
     };
 
   public:
-    using index_t = uint8_t;
+    using index_t = uint16_t;
+
+    static const index_t MaxStrings = UINT16_MAX;
+
+    struct Stats
+    {
+        uint32_t hits          = 0; // string was already interned
+        uint32_t misses        = 0; // string had to be added
+        uint32_t outOfCapacity = 0; // string could not be added, MaxStrings in use
+    };
 
     static const string& str(const index_t& index)
     {
         static string dummy;
-        const auto&   it = strings.find(index);
-        if (it == strings.end())
+        if (index == 0 or index >= entries.size())
             return dummy;
-        return it->second.str;
+        return entries[index].str;
     }
 
     static void use(const index_t& index)
     {
-        auto it = strings.find(index);
-        if (it != strings.end())
-            it->second.used++;
+        if (index and index < entries.size())
+            entries[index].used++;
     }
 
     static void release(const index_t& index)
     {
-        auto it = strings.find(index);
-        if (it != strings.end())
+        if (index == 0 or index >= entries.size() or entries[index].used == 0)
+            return;
+        StringCounter& entry = entries[index];
+        if (--entry.used == 0)
         {
-            it->second.used--;
-            if (it->second.used == 0)
-            {
-                strings.erase(it);
-                // Serial << "Removing string(" << it->second.str.c_str() << ") size=" << strings.size() << endl;
-            }
+            lookup.erase(std::string_view(entry.str));
+            stringBytes -= entry.str.length();
+            string().swap(entry.str); // frees the heap, assigning an empty string would keep the capacity
+            freeIndexes.push_back(index);
         }
     }
 
     static uint16_t count()
     {
-        return strings.size();
+        return lookup.size();
+    }
+
+    static const Stats& stats()
+    {
+        return statistics;
+    }
+
+    // Approximate heap used by the interned strings and the tables.
+    static size_t memoryUsed()
+    {
+        return stringBytes + entries.size() * sizeof(StringCounter) + freeIndexes.capacity() * sizeof(index_t) +
+               lookup.bucket_count() * sizeof(void*) + lookup.size() * (sizeof(Lookup::value_type) + 2 * sizeof(void*));
     }
 
   private:
     friend class IndexedString;
 
-    // increment use of str or create a new index
-    static index_t strToIndex(const char* str, uint8_t len)
+    // increment use of str or create a new index, returns 0 if out of capacity
+    static index_t strToIndex(const char* str, uint16_t len)
     {
-        for (auto it = strings.begin(); it != strings.end(); it++)
+        auto it = lookup.find(std::string_view(str, len));
+        if (it != lookup.end())
         {
-            if (it->second.str.length() == len && strcmp(it->second.str.c_str(), str) == 0)
-            {
-                it->second.used++;
-                return it->first;
-            }
+            entries[it->second].used++;
+            statistics.hits++;
+            return it->second;
+        }
+
+        index_t index;
+        if (freeIndexes.size())
+        {
+            index = freeIndexes.back();
+            freeIndexes.pop_back();
         }
-        for (index_t index = 1; index; index++)
+        else if (entries.size() <= MaxStrings)
         {
-            if (strings.find(index) == strings.end())
+            if (entries.empty())
             {
-                strings[index].str = string(str, len);
-                strings[index].used++;
-                // Serial << "Creating index " << index << " for (" << strings[index].str.c_str() << ") len=" << len << endl;
-                return index;
+                entries.emplace_back(); // index 0 is not used
             }
+            index = entries.size();
+            entries.emplace_back();
+        }
+        else
+        {
+            statistics.outOfCapacity++;
+            return 0;
         }
-        return 0; // TODO out of indexes
+        StringCounter& entry = entries[index];
+        entry.str            = string(str, len);
+        entry.used           = 1;
+        stringBytes += len;
+        lookup.emplace(std::string_view(entry.str), index);
+        statistics.misses++;
+        return index;
     }
 
-    using Strings = std::unordered_map<index_t, StringCounter>;
+    // deque: the strings never move, so lookup can reference them
+    using Entries = std::deque<StringCounter>;
+    using Lookup  = std::unordered_map<std::string_view, index_t>;
 
-    static Strings strings;
+    static Entries              entries;
+    static Lookup               lookup;
+    static std::vector<index_t> freeIndexes;
+    static size_t               stringBytes;
+    static Stats                statistics;
 };
 
 class IndexedString
@@ -105,7 +148,7 @@ class IndexedString
         index = source.index;
     }
 
-    IndexedString(const char* str, uint8_t len)
+    IndexedString(const char* str, uint16_t len)
     {
         index = StringIndexer::strToIndex(str, len);
     }
@@ -120,6 +163,7 @@ class IndexedString
     IndexedString& operator=(const IndexedString& source)
     {
         StringIndexer::use(source.index);
+        StringIndexer::release(index);
         index = source.index;
         return *this;
     }
@@ -144,6 +188,12 @@ class IndexedString
         return index;
     }
 
+    // false if the string could not be interned (out of capacity)
+    bool valid() const
+    {
+        return index != 0;
+    }
+
   private:
     StringIndexer::index_t index;
 };
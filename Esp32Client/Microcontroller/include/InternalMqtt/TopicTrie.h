@@ -0,0 +1,259 @@
+#pragma once
+#include "Defines.hpp"
+
+#ifdef USE_INTERNAL_MQTT
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/***
+ * Level segmented subscription index shared by all clients of a broker.
+ *
+ * Each node is one topic level. Wildcards get their own child slot:
+ *   '+' matches exactly one level,
+ *   '#' matches the remaining levels (zero or more), must be the last level,
+ *   '*' matches zero or more levels and may be followed by further levels.
+ * Topics starting with '$' are not matched by filters starting with a wildcard.
+ *
+ * match() walks the trie once per published topic and returns every subscriber
+ * instead of testing each subscription of each client.
+ */
+template <class Subscriber>
+class TopicTrie
+{
+  public:
+    using Subscribers = std::vector<Subscriber>;
+
+    void insert(std::string_view filter, Subscriber subscriber)
+    {
+        Node* node = &root;
+        forEachLevel(filter,
+                     [&](std::string_view level)
+                     {
+                         std::unique_ptr<Node>& child = node->child(level);
+                         if (!child)
+                         {
+                             child = std::make_unique<Node>();
+                         }
+                         node = child.get();
+                     });
+        add(node->subscribers, subscriber);
+    }
+
+    void remove(std::string_view filter, Subscriber subscriber)
+    {
+        std::vector<Node*> path{&root};
+        bool               found = true;
+        forEachLevel(filter,
+                     [&](std::string_view level)
+                     {
+                         if (found)
+                         {
+                             Node* child = path.back()->findChild(level);
+                             if (child == nullptr)
+                             {
+                                 found = false;
+                             }
+                             else
+                             {
+                                 path.push_back(child);
+                             }
+                         }
+                     });
+        if (found)
+        {
+            erase(path.back()->subscribers, subscriber);
+            prune(root);
+        }
+    }
+
+    // Removes all subscriptions of subscriber (client disconnected).
+    void removeSubscriber(Subscriber subscriber)
+    {
+        removeSubscriber(root, subscriber);
+        prune(root);
+    }
+
+    // Collects all subscribers of topic in one walk. Each subscriber is returned once.
+    void match(std::string_view topic, Subscribers& result) const
+    {
+        result.clear();
+        std::vector<std::string_view> levels;
+        forEachLevel(topic, [&](std::string_view level) { levels.push_back(level); });
+        bool system = topic.size() and topic[0] == '$';
+        match(root, levels, 0, system, result);
+        if (result.size() > 1)
+        {
+            std::sort(result.begin(), result.end());
+            result.erase(std::unique(result.begin(), result.end()), result.end());
+        }
+    }
+
+    bool empty() const
+    {
+        return root.isEmpty();
+    }
+
+  private:
+    struct Node
+    {
+        std::map<std::string, std::unique_ptr<Node>, std::less<>> children;
+
+        std::unique_ptr<Node> plus; // '+'
+        std::unique_ptr<Node> hash; // '#'
+        std::unique_ptr<Node> star; // '*'
+        Subscribers           subscribers;
+
+        std::unique_ptr<Node>& child(std::string_view level)
+        {
+            if (level == "+")
+                return plus;
+            if (level == "#")
+                return hash;
+            if (level == "*")
+                return star;
+            auto it = children.find(level);
+            if (it == children.end())
+            {
+                it = children.emplace(std::string(level), nullptr).first;
+            }
+            return it->second;
+        }
+
+        Node* findChild(std::string_view level) const
+        {
+            if (level == "+")
+                return plus.get();
+            if (level == "#")
+                return hash.get();
+            if (level == "*")
+                return star.get();
+            auto it = children.find(level);
+            return it == children.end() ? nullptr : it->second.get();
+        }
+
+        bool isEmpty() const
+        {
+            return subscribers.empty() and children.empty() and !plus and !hash and !star;
+        }
+    };
+
+    template <class Fn>
+    static void forEachLevel(std::string_view topic, Fn fn)
+    {
+        size_t start = 0;
+        while (true)
+        {
+            size_t slash = topic.find('/', start);
+            if (slash == std::string_view::npos)
+            {
+                fn(topic.substr(start));
+                return;
+            }
+            fn(topic.substr(start, slash - start));
+            start = slash + 1;
+        }
+    }
+
+    static void add(Subscribers& subscribers, Subscriber subscriber)
+    {
+        if (std::find(subscribers.begin(), subscribers.end(), subscriber) == subscribers.end())
+        {
+            subscribers.push_back(subscriber);
+        }
+    }
+
+    static void erase(Subscribers& subscribers, Subscriber subscriber)
+    {
+        subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), subscriber), subscribers.end());
+    }
+
+    static void append(const Subscribers& from, Subscribers& result)
+    {
+        result.insert(result.end(), from.begin(), from.end());
+    }
+
+    static void match(const Node& node, const std::vector<std::string_view>& levels, size_t index, bool system, Subscribers& result)
+    {
+        // Wildcards on the first level must not match $SYS like topics.
+        bool wildcards = not(system and index == 0);
+
+        if (node.hash and wildcards)
+        {
+            append(node.hash->subscribers, result);
+        }
+        if (node.star and wildcards)
+        {
+            for (size_t next = index; next <= levels.size(); next++)
+            {
+                match(*node.star, levels, next, system, result);
+            }
+        }
+        if (index == levels.size())
+        {
+            append(node.subscribers, result);
+            return;
+        }
+        auto it = node.children.find(levels[index]);
+        if (it != node.children.end())
+        {
+            match(*it->second, levels, index + 1, system, result);
+        }
+        if (node.plus and wildcards)
+        {
+            match(*node.plus, levels, index + 1, system, result);
+        }
+    }
+
+    static void removeSubscriber(Node& node, Subscriber subscriber)
+    {
+        erase(node.subscribers, subscriber);
+        for (auto& child : node.children)
+        {
+            removeSubscriber(*child.second, subscriber);
+        }
+        for (auto* wildcard : {&node.plus, &node.hash, &node.star})
+        {
+            if (*wildcard)
+            {
+                removeSubscriber(**wildcard, subscriber);
+            }
+        }
+    }
+
+    // Frees the nodes without subscribers below them.
+    static void prune(Node& node)
+    {
+        for (auto it = node.children.begin(); it != node.children.end();)
+        {
+            prune(*it->second);
+            if (it->second->isEmpty())
+            {
+                it = node.children.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        for (auto* wildcard : {&node.plus, &node.hash, &node.star})
+        {
+            if (*wildcard)
+            {
+                prune(**wildcard);
+                if ((*wildcard)->isEmpty())
+                {
+                    wildcard->reset();
+                }
+            }
+        }
+    }
+
+    Node root;
+};
+
+#endif // USE_INTERNAL_MQTT
@@ -0,0 +1,56 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Histogram of durations with logarithmic buckets.
+// --------------------------------------------------------------------------------------------------------------------
+#ifndef __LATENCY_HISTOGRAM_HPP__
+#define __LATENCY_HISTOGRAM_HPP__
+
+#include <stdint.h>
+
+namespace IotZoo
+{
+    /// @brief Counts durations in buckets of powers of two: bucket 0 counts 0 µs, bucket n counts [2^(n-1), 2^n) µs. The last
+    ///        bucket counts everything from 2^(BucketCount - 2) µs on. Fixed size, adding is a few instructions.
+    class LatencyHistogram
+    {
+      public:
+        static const uint8_t BucketCount = 24; // the last bucket starts at 4.2 s
+
+        void add(uint32_t micros)
+        {
+            uint8_t bucket = micros == 0 ? 0 : 32 - __builtin_clz(micros);
+            if (bucket >= BucketCount)
+            {
+                bucket = BucketCount - 1;
+            }
+            buckets[bucket]++;
+        }
+
+        uint32_t getCount(uint8_t bucket) const
+        {
+            return buckets[bucket];
+        }
+
+        /// @brief Number of buckets up to the last one that is not empty, for a compact output.
+        uint8_t getUsedBucketCount() const
+        {
+            uint8_t count = BucketCount;
+            while (count > 0 && buckets[count - 1] == 0)
+            {
+                count--;
+            }
+            return count;
+        }
+
+      protected:
+        uint32_t buckets[BucketCount] = {};
+    };
+} // namespace IotZoo
+
+#endif // __LATENCY_HISTOGRAM_HPP__
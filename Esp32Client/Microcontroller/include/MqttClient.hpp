@@ -17,9 +17,23 @@
 #include "EspmqttClient.h"
 
 #include <Arduino.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+#ifdef USE_DUAL_CORE
+#include "SpscQueue.hpp"
+#include <memory>
+#endif
 
 namespace IotZoo
 {
+    /// @brief Client for the MQTT broker of the IotZoo. With USE_DUAL_CORE, the client runs in a task of its own (network
+    ///        task): publishes and subscriptions of the device task (loop()) are queued for the network task and the
+    ///        callbacks of received messages are queued for dispatchReceivedMessages(). Any other task may publish as
+    ///        well, e.g. the NimBLE callbacks: the producers of the outbound queue take turns on outboundLock, and the
+    ///        offline queue is guarded by pendingLock. While the broker is not reachable, text publishes are kept in RAM
+    ///        and sent after reconnecting.
     class MqttClient
     {
       protected:
@@ -34,12 +48,15 @@ namespace IotZoo
         void enableLastWillMessage(const String& topic, const String& message,
                                    const bool retain = false); // Must be set before the first loop() call.
 
+        /// @brief Publishes an event or message. While offline it is kept, in order, until the connection is back.
+        /// @return false if the message is lost.
         bool publish(const String& topic, const String& payload, bool retain = false);
 
-        bool publish(const String& topic, const uint8_t* payload, unsigned int payloadLength, boolean retained = false)
-        {
-            return printSuccess(mqttClient->publish(topic.c_str(), payload, payloadLength, retained));
-        }
+        /// @brief Publishes a state value like a temperature. While offline only the latest value of topic is kept.
+        bool publishState(const String& topic, const String& payload, bool retain = false);
+
+        /// @brief Publishes binary data (streams). It is not kept while offline.
+        bool publish(const String& topic, const uint8_t* payload, unsigned int payloadLength, boolean retained = false);
 
         /// @brief
         /// @param topic
@@ -61,8 +78,131 @@ namespace IotZoo
         /// Main loop, to call at each sketch loop()
         void loop();
 
+        /// @brief Number of publishes waiting for the connection.
+        size_t getPendingCount() const
+        {
+            return pendingCount;
+        }
+
+        /// @brief Number of publishes lost because too many were waiting for the connection.
+        uint32_t getPendingDropped() const
+        {
+            return pendingDropped;
+        }
+
+        /// @brief Number of state values replaced by a newer value while waiting for the connection.
+        uint32_t getPendingCoalesced() const
+        {
+            return pendingCoalesced;
+        }
+
       protected:
+        /// @brief A publish waiting for the connection.
+        struct PendingMessage
+        {
+            String topic;
+            String payload;
+            bool   retain = false;
+            bool   state  = false; // only the latest value of the topic is kept
+        };
+
+        static const size_t MaxPendingMessages = 64;
+        static const size_t MaxPendingBytes    = 16384; // sum of the payload lengths
+        static const size_t MaxDrainPerLoop    = 4;     // publishes per loop() after reconnecting, does not flood the broker
+
+        std::mutex                 pendingLock;       // publishes of other tasks while loop() drains
+        std::deque<PendingMessage> pending;           // oldest first, guarded by pendingLock
+        size_t                     pendingBytes = 0;  // guarded by pendingLock
+        std::atomic<size_t>        pendingCount{0};   // read by any task
+        std::atomic<uint32_t>      pendingDropped{0};
+        std::atomic<uint32_t>      pendingCoalesced{0};
+
         bool printSuccess(bool ok);
+
+        bool publishText(const String& topic, const String& payload, bool retain, bool state);
+
+        /// @brief Publishes now if connected and nothing is waiting, otherwise queues the message behind the waiting ones.
+        bool publishOrStore(const String& topic, const String& payload, bool retain, bool state);
+
+        /// @brief pendingLock must be held.
+        void store(const String& topic, const String& payload, bool retain, bool state);
+
+        /// @brief Sends up to MaxDrainPerLoop waiting publishes.
+        void drainPending();
+
+#ifdef USE_DUAL_CORE
+      public:
+        /// @brief A publish, subscription or unsubscription queued for the network task.
+        struct OutboundCommand
+        {
+            enum class Kind : uint8_t
+            {
+                Publish,
+                Subscribe,
+                Unsubscribe
+            };
+
+            Kind                             kind = Kind::Publish;
+            String                           topic;
+            String                           payload; // may contain binary data, use payload.length()
+            bool                             retain = false;
+            bool                             binary = false; // not kept while offline
+            bool                             state  = false; // see publishState()
+            uint8_t                          qos    = 0;
+            MessageReceivedCallbackWithTopic callback; // Subscribe only
+        };
+
+        /// @brief A received message queued for the device task.
+        struct InboundMessage
+        {
+            std::shared_ptr<MessageReceivedCallbackWithTopic> callback;
+            String                                            topic;
+            String                                            payload;
+        };
+
+        static const size_t QueueCapacity = 32;
+
+        // Multi-producer, single-consumer: every task pushes under outboundLock, only loop() pops, without a lock.
+        using OutboundQueue = SpscQueue<OutboundCommand, QueueCapacity>;
+        // Single-producer, single-consumer and lock-free on both sides: loop() pushes, the device task pops.
+        using InboundQueue = SpscQueue<InboundMessage, QueueCapacity>;
+
+        /// @brief Must be called by the network task before it calls loop() the first time. Until then, every call is
+        ///        executed directly (setup()).
+        void setNetworkTask(TaskHandle_t task)
+        {
+            networkTask = task;
+        }
+
+        /// @brief Calls the callbacks of the received messages. Must be called by one task only, the device task.
+        void dispatchReceivedMessages();
+
+        const OutboundQueue& getOutboundQueue() const
+        {
+            return outbound;
+        }
+
+        const InboundQueue& getInboundQueue() const
+        {
+            return inbound;
+        }
+
+      protected:
+        bool isNetworkTask() const
+        {
+            return nullptr == networkTask || xTaskGetCurrentTaskHandle() == networkTask;
+        }
+
+        bool publishNow(const String& topic, const uint8_t* payload, unsigned int payloadLength, bool retained);
+
+        /// @brief SpscQueue allows one producer at a time, so the tasks other than the network task take turns.
+        bool pushOutbound(OutboundCommand&& command);
+
+        std::mutex            outboundLock; // serializes the producers of outbound
+        OutboundQueue         outbound;     // produced by any task holding outboundLock, consumed by loop()
+        InboundQueue          inbound;  // produced by loop(), consumed by dispatchReceivedMessages()
+        TaskHandle_t volatile networkTask = nullptr;
+#endif // USE_DUAL_CORE
     };
 } // namespace IotZoo
 #endif
@@ -0,0 +1,90 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Effects rendered on the microcontroller for WS2818 and PixelMatrix: fade, blink, chase, breathe, gradient and scroll.
+// --------------------------------------------------------------------------------------------------------------------
+#include "Defines.hpp"
+#ifdef USE_WS2818
+#ifndef __PIXEL_EFFECTS_HPP__
+#define __PIXEL_EFFECTS_HPP__
+
+#include <Arduino.h>
+#include <vector>
+
+namespace IotZoo
+{
+    enum class PixelEffectType
+    {
+        Fade,     // from color to color2 in periodMs, then stays color2
+        Blink,    // color for the first half of periodMs, color2 for the second half
+        Chase,    // width pixels of color run through the range in periodMs, the others are color2
+        Breathe,  // smoothly from color2 to color and back in periodMs
+        Gradient, // color at the first pixel, color2 at the last one; drawn once
+        Scroll    // a gradient from color to color2 and back, moving through the range in periodMs
+    };
+
+    struct PixelEffect
+    {
+        PixelEffectType Type        = PixelEffectType::Blink;
+        uint16_t        StartIndex  = 0;
+        uint16_t        Length      = 1;
+        uint32_t        Color       = 0;
+        uint32_t        Color2      = 0;
+        uint16_t        PeriodMs    = 1000;
+        uint32_t        DurationMs  = 0;   // 0: until stopped, otherwise the pixels are turned off afterwards
+        uint8_t         Opacity     = 255; // blends with the effects started before on the same pixels
+        uint8_t         Width       = 1;   // Chase only
+        unsigned long   StartMillis = 0;
+    };
+
+    /// @brief Renders the running effects into the colors at a fixed frame rate. Integer math only: the position in the
+    ///        period is a 16 bit fraction, colors are mixed per channel with it. An effect replaces the running effect on
+    ///        exactly the same range.
+    class PixelEffects
+    {
+      public:
+        static const uint8_t MaxEffects = 8;
+
+        /// @return false if MaxEffects are running.
+        bool start(const PixelEffect& effect);
+
+        /// @brief Stops all effects. Their pixels keep the color of the last frame.
+        void stop();
+
+        bool isEmpty() const
+        {
+            return effects.empty();
+        }
+
+        /// @brief Renders a frame into colors (0xRRGGBB per pixel) if it is due.
+        /// @return true if colors have changed, first and last are the changed range then.
+        bool render(unsigned long now, unsigned long frameIntervalMs, uint32_t* colors, uint16_t numberOfPixels, uint16_t& first, uint16_t& last);
+
+        /// @brief Milliseconds until the next frame is due.
+        unsigned long getMillisUntilNextFrame(unsigned long now) const;
+
+      protected:
+        /// @brief Mixes a and b per channel, fraction 0 is a, 65536 is b.
+        static uint32_t mix(uint32_t a, uint32_t b, uint32_t fraction);
+
+        /// @brief 0 -> 65536 -> 0 while phase runs through 0 ... 65535.
+        static uint32_t triangle(uint16_t phase);
+
+        /// @brief The color of the pixel at offset in the range of effect, phase is the position in the period (0 ... 65536).
+        static uint32_t colorAt(const PixelEffect& effect, uint16_t offset, uint32_t phase);
+
+        /// @brief Writes color to the pixel if it differs, only changes are sent.
+        bool setPixel(uint32_t* colors, uint16_t index, uint32_t color, uint16_t& first, uint16_t& last, bool changed);
+
+        std::vector<PixelEffect> effects;
+        unsigned long            nextFrameMillis = 0;
+    };
+} // namespace IotZoo
+
+#endif // __PIXEL_EFFECTS_HPP__
+#endif // USE_WS2818
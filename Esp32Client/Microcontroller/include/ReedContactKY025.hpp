@@ -19,6 +19,10 @@
 
 namespace IotZoo
 {
+    /// @brief Reed contact, publishes the revolutions per minute and the number of pulses.
+    ///        Default: an interrupt counts the pulses with a software debounce of 300 ms, which limits the speed to
+    ///        200 RPM. With USE_KY025_PCNT the hardware pulse counter counts the falling edges without any
+    ///        CPU time per pulse and loop() samples it every SampleIntervalMs.
     class KY025 : public DeviceBase
     {
       public:
@@ -26,14 +30,49 @@ namespace IotZoo
 
         void loop() override;
 
-        void addMqttTopicsToRegister(std::vector<Topic>* const topics) const override;
+        unsigned long getLoopIntervalMs() const override
+        {
+#ifdef USE_KY025_PCNT
+            return SampleIntervalMs;
+#else
+            return PublishIntervalMs;
+#endif
+        }
 
-        bool setPayloadPropertyOfTopicLink(TopicLink& topicLink) override;
+        void addMqttTopicsToRegister(std::vector<Topic>* const topics) const override;
 
       private:
+        static const unsigned long PublishIntervalMs = 200;  // publishes at most every 200 ms
+        static const unsigned long StandstillMs      = 3000; // publishes rpm 0 after 3 s without a pulse
+
+#ifdef USE_KY025_PCNT
+        static const unsigned long SampleIntervalMs = 20;   // also the resolution of the period measurement
+        static const unsigned long WindowMs         = 1000; // rpm = pulses in the window, if there are enough of them
+        static const uint32_t      MinWindowPulses  = 10;   // below, the period between two pulses is more exact
+
+        /// @brief Reads the pulse counter and updates counter and rpm.
+        void samplePulseCounter();
+
+        int16_t       lastCount         = 0;
+        unsigned long windowStartMillis = 0;
+        uint32_t      windowPulses      = 0;
+        unsigned long lastPulseMillis   = 0;
+        float         periodRpm         = 0; // from the time between the last two sampled pulses
+#endif
+
+        // Publishes value via MQTT and signals it to the TopicLinks.
+        void publishValue(const String& topic, const String& value);
+
         u16_t intervalMs;
 
         unsigned long lastLoopMillis = 0;
+
+        uint32_t counter          = 0; // pulses since the start
+        uint32_t publishedCounter = 0;
+        float    rpm              = 0;
+
+        String topicRpm;
+        String topicCounter;
     };
 } // namespace IotZoo
 
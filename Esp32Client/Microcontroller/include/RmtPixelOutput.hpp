@@ -0,0 +1,75 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Sends WS2812/WS2818 frames with the RMT peripheral, without blocking the CPU or disabling the interrupts.
+// --------------------------------------------------------------------------------------------------------------------
+#include "Defines.hpp"
+#ifdef USE_WS2818_RMT
+#ifndef __RMT_PIXEL_OUTPUT_HPP__
+#define __RMT_PIXEL_OUTPUT_HPP__
+
+#include <Arduino.h>
+#include <atomic>
+#include <driver/rmt.h>
+
+namespace IotZoo
+{
+    /// @brief Two frame buffers: the back buffer is filled while the front buffer is being sent. send() swaps them and
+    ///        starts the transmission, the RMT driver converts the bytes to pulses in its interrupt. Only one instance,
+    ///        the RMT driver has one end of transmission callback for all channels.
+    class RmtPixelOutput
+    {
+      public:
+        /// @brief Called in the RMT interrupt when a frame has been sent.
+        typedef void (*FrameSentCallback)(void* arg);
+
+        RmtPixelOutput(uint8_t pin, size_t frameSize, rmt_channel_t channel = RMT_CHANNEL_0);
+
+        ~RmtPixelOutput();
+
+        /// @brief The buffer for the next frame, bytes in the order of the strip (GRB).
+        uint8_t* getBackBuffer()
+        {
+            return frames[1 - front];
+        }
+
+        /// @brief Sends the first length bytes of the back buffer. Pixels behind keep their color. Waits until the line has
+        ///        been low for the reset time since the previous frame, otherwise the strip would take both as one frame.
+        /// @return false if the previous frame is still being sent.
+        bool send(size_t length);
+
+        bool isBusy() const
+        {
+            return busy.load(std::memory_order_acquire);
+        }
+
+        void setFrameSentCallback(FrameSentCallback callback, void* arg)
+        {
+            frameSentCallback    = callback;
+            frameSentCallbackArg = arg;
+        }
+
+      protected:
+        static void IRAM_ATTR translate(const void* source, rmt_item32_t* destination, size_t sourceSize, size_t wantedItems,
+                                        size_t* translatedSize, size_t* itemCount);
+
+        static void onTransmissionEnd(rmt_channel_t channel, void* arg);
+
+        rmt_channel_t         channel;
+        size_t                frameSize;
+        uint8_t*              frames[2]            = {nullptr, nullptr};
+        uint8_t               front                = 0;
+        std::atomic_bool      busy{false};
+        std::atomic<uint32_t> frameEndMicros{0}; // micros() when the previous frame was sent, set in the RMT interrupt
+        FrameSentCallback     frameSentCallback    = nullptr;
+        void*                 frameSentCallbackArg = nullptr;
+    };
+} // namespace IotZoo
+
+#endif // __RMT_PIXEL_OUTPUT_HPP__
+#endif // USE_WS2818_RMT
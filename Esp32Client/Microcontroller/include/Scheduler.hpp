@@ -0,0 +1,120 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Cooperative scheduler for the main loop.
+// --------------------------------------------------------------------------------------------------------------------
+#ifndef __SCHEDULER_HPP__
+#define __SCHEDULER_HPP__
+
+#include "LatencyHistogram.hpp"
+
+#include <Arduino.h>
+#include <WString.h>
+#include <functional>
+#include <vector>
+
+namespace IotZoo
+{
+    class DeviceBase;
+
+    /// @brief Runs tasks cooperatively in the main loop. Each run of a task returns when the task wants to run again, so
+    ///        run() calls only the tasks that are due and tells the caller how long it may idle.
+    class Scheduler
+    {
+      public:
+        /// @brief Runs the task once and returns the milliseconds until it wants to run again.
+        using Callback = std::function<unsigned long()>;
+
+        using TaskId = size_t;
+
+        struct Task
+        {
+            String        name;
+            Callback      callback;
+            unsigned long nextRunMillis = 0;
+            volatile bool triggered     = false; // set by trigger(), runs the task at the next run()
+
+            // Runtime measured with esp_timer_get_time().
+            uint32_t runs         = 0;
+            uint64_t totalMicros  = 0;
+            uint32_t worstMicros  = 0; // worst case execution time
+            uint32_t latestMicros = 0;
+        };
+
+        /// @brief Runtime of a task, see Task.
+        struct TaskStatistics
+        {
+            const char* name        = nullptr; // of the task, which outlives the statistics
+            uint32_t    runs        = 0;
+            uint64_t    totalMicros = 0;
+            uint32_t    worstMicros = 0;
+        };
+
+        /// @brief The runtime statistics of a scheduler, all from the same moment.
+        struct Statistics
+        {
+            LatencyHistogram            runHistogram;
+            std::vector<TaskStatistics> tasks; // in the order of running
+        };
+
+        /// @brief Adds a task that declares its next run itself.
+        TaskId addTask(const String& name, Callback callback);
+
+        /// @brief Adds a task that runs every intervalMs.
+        TaskId addTask(const String& name, unsigned long intervalMs, std::function<void()> callback);
+
+        /// @brief Adds a task calling device->loop() at the cadence the device declares with getLoopIntervalMs().
+        TaskId addDevice(const String& name, DeviceBase* device);
+
+        /// @brief Lets the task run as soon as possible. May be called from other tasks or interrupts.
+        void trigger(TaskId taskId)
+        {
+            if (taskId < tasks.size())
+            {
+                tasks[taskId].triggered = true;
+            }
+        }
+
+        /// @brief Runs the tasks that are due.
+        /// @param maxIdleMs upper limit of the returned idle time.
+        /// @return the milliseconds until the next task is due.
+        unsigned long run(unsigned long maxIdleMs);
+
+        const std::vector<Task>& getTasks() const
+        {
+            return tasks;
+        }
+
+        /// @brief Durations of all calls of run(), i.e. the loop durations without idling.
+        const LatencyHistogram& getRunHistogram() const
+        {
+            return runHistogram;
+        }
+
+        /// @brief The current statistics. Must be called by the task calling run().
+        Statistics getStatistics() const;
+
+        /// @brief Copies the current statistics for getPublishedStatistics(). Must be called by the task calling run(),
+        ///        between two runs. The copy takes a few hundred bytes under a spinlock and allocates nothing.
+        void publishStatistics();
+
+        /// @brief The statistics as of the last publishStatistics(). May be called from any task: on a 32 bit CPU, reading
+        ///        the counters of a scheduler running on the other core could see a torn totalMicros or a half updated
+        ///        histogram. The tasks must have been added before.
+        Statistics getPublishedStatistics() const;
+
+      protected:
+        std::vector<Task>           tasks; // in the order of adding, which is the order of running
+        LatencyHistogram            runHistogram;
+        LatencyHistogram            publishedHistogram; // guarded by statisticsLock
+        std::vector<TaskStatistics> publishedTasks;     // guarded by statisticsLock, sized by addTask()
+        mutable portMUX_TYPE        statisticsLock = portMUX_INITIALIZER_UNLOCKED;
+    };
+} // namespace IotZoo
+
+#endif // __SCHEDULER_HPP__
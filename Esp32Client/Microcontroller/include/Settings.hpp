@@ -13,6 +13,8 @@
 
 // To save data permanently in the flash.
 #include <Preferences.h>
+#include <map>
+#include <mutex>
 
 namespace IotZoo
 {
@@ -62,11 +64,16 @@ namespace IotZoo
 
     */
 
+    /// @brief Settings are read from the flash once and then served from RAM. Changes are written back to the flash by loop()
+    ///        when no further change has arrived for FlushDelayMs, or immediately by flush(). Thread safe, the REST server may
+    ///        run on another core than the devices (USE_DUAL_CORE).
     class Settings
     {
         const String ProjectNameKey      = "ProjectName";
         const char*  NamespaceNameConfig = "config";
 
+        static const unsigned long FlushDelayMs = 2000;
+
       public:
         Settings();
 
@@ -112,8 +119,46 @@ namespace IotZoo
 
         void setIntervalTemperatureSensorsMillis(long interval);
 
+        /// @brief Writes changed settings to the flash when the last change is older than FlushDelayMs.
+        void loop();
+
+        /// @brief Writes all changed settings to the flash now, e.g. before a restart.
+        /// @return false if at least one setting could not be written.
+        bool flush();
+
       protected:
+        enum class EntryType : uint8_t
+        {
+            Text,
+            Long,
+            UShort
+        };
+
+        struct Entry
+        {
+            EntryType type   = EntryType::Text;
+            String    text;
+            long      number = 0;
+            bool      dirty  = false;
+        };
+
         Preferences preferences;
+
+        std::map<String, Entry> entries; // cache of the settings read or written so far
+        unsigned long           lastChangeMillis = 0;
+        bool                    hasDirtyEntries  = false;
+        std::recursive_mutex    entriesLock; // guards entries, lastChangeMillis and hasDirtyEntries
+
+        // Returns the cached entry of key, reading it from the flash (with fallback) on first use. entriesLock must be held
+        // while the entry is used.
+        Entry& getEntry(const String& key, EntryType type, long fallbackNumber = 0);
+
+        // Returns a copy of the number of key, taken while entriesLock is held.
+        long getNumber(const String& key, EntryType type, long fallbackNumber);
+
+        void setText(const String& key, const String& text);
+
+        void setNumber(const String& key, EntryType type, long number);
     };
 } // namespace IotZoo
 
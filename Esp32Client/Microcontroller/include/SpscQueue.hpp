@@ -0,0 +1,99 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Lock-free queue between exactly one producing and one consuming task.
+// --------------------------------------------------------------------------------------------------------------------
+#ifndef __SPSC_QUEUE_HPP__
+#define __SPSC_QUEUE_HPP__
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+
+namespace IotZoo
+{
+    /// @brief Bounded ring buffer for one producer task and one consumer task, which may run on different cores. The
+    ///        producer only writes head, the consumer only writes tail, so neither side ever waits for the other. A push
+    ///        into the full queue is dropped and counted.
+    template <typename T, size_t Capacity>
+    class SpscQueue
+    {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+      public:
+        /// @brief Called by the producer only.
+        /// @return false if the queue is full and the item is dropped.
+        bool push(T&& item)
+        {
+            size_t head = this->head.load(std::memory_order_relaxed);
+            if (head - tail.load(std::memory_order_acquire) >= Capacity)
+            {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            slots[head & (Capacity - 1)] = std::move(item);
+            this->head.store(head + 1, std::memory_order_release);
+
+            size_t depth = head + 1 - tail.load(std::memory_order_relaxed);
+            if (depth > highWater.load(std::memory_order_relaxed))
+            {
+                highWater.store(depth, std::memory_order_relaxed);
+            }
+            return true;
+        }
+
+        /// @brief Called by the consumer only.
+        /// @return false if the queue is empty.
+        bool pop(T& item)
+        {
+            size_t tail = this->tail.load(std::memory_order_relaxed);
+            if (tail == head.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            item = std::move(slots[tail & (Capacity - 1)]);
+            slots[tail & (Capacity - 1)] = T(); // release the memory of the item now, not when the slot is reused
+            this->tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// @brief Number of queued items, may be called from any task.
+        size_t getDepth() const
+        {
+            return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+        }
+
+        /// @brief The largest depth since the start.
+        size_t getHighWater() const
+        {
+            return highWater.load(std::memory_order_relaxed);
+        }
+
+        /// @brief Number of items dropped because the queue was full.
+        uint32_t getDropped() const
+        {
+            return dropped.load(std::memory_order_relaxed);
+        }
+
+        static constexpr size_t getCapacity()
+        {
+            return Capacity;
+        }
+
+      protected:
+        T slots[Capacity];
+
+        std::atomic<size_t>   head{0}; // next slot to write, written by the producer
+        std::atomic<size_t>   tail{0}; // next slot to read, written by the consumer
+        std::atomic<size_t>   highWater{0};
+        std::atomic<uint32_t> dropped{0};
+    };
+} // namespace IotZoo
+
+#endif // __SPSC_QUEUE_HPP__
@@ -55,6 +55,7 @@ namespace IotZoo
         TM1638plus *tm1638plus;
         int8_t lastButtonsState;
         String serverDownText = "--------";
+        String topicButtonRowState;
     };
 }
 
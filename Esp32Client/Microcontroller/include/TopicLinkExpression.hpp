@@ -0,0 +1,68 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Condition of a TopicLink, compiled once from its json Expression.
+// --------------------------------------------------------------------------------------------------------------------
+#ifndef __TOPIC_LINK_EXPRESSION_HPP__
+#define __TOPIC_LINK_EXPRESSION_HPP__
+
+#include <WString.h>
+#include <vector>
+
+namespace IotZoo
+{
+    /// @brief Compiled TopicLink Expression. Supported json:
+    ///        { "Operator": ">", "Value": "130" }
+    ///        { "And": [ { "Operator": ">=", "Value": 10 }, { "Operator": "<", "Value": 20 } ] }
+    ///        { "Or": [ { "Operator": "==", "Value": "open" }, { "And": [ ... ] } ] }
+    ///        Operators: <, <=, >, >=, ==, !=. Values that are numbers are compared as numbers, others as text.
+    class TopicLinkExpression
+    {
+      public:
+        enum class Operator : uint8_t
+        {
+            Always = 0,
+            Never,
+            Less,
+            LessOrEqual,
+            Greater,
+            GreaterOrEqual,
+            Equal,
+            NotEqual
+        };
+
+        struct Condition
+        {
+            Operator op          = Operator::Always;
+            bool     startsGroup = false; // starts a new Or alternative, conditions of one group are and-ed
+            bool     numeric     = true;
+            double   value       = 0;
+            String   text;
+
+            bool test(const String& payload, double number) const;
+        };
+
+        /// @brief Always true.
+        TopicLinkExpression() = default;
+
+        /// @brief Empty or "null" is always true, an invalid expression is never true.
+        static TopicLinkExpression compile(const String& expression);
+
+        bool evaluate(const String& payload) const;
+
+        bool isAlways() const
+        {
+            return conditions.empty();
+        }
+
+      private:
+        std::vector<Condition> conditions; // Or of And groups
+    };
+} // namespace IotZoo
+
+#endif // __TOPIC_LINK_EXPRESSION_HPP__
@@ -16,9 +16,16 @@
 #define __WS2818_HPP__
 
 #include "DeviceBase.hpp"
+#include "GammaTable.hpp"
+#include "PixelEffects.hpp"
+#ifdef USE_WS2818_RMT
+#include "RmtPixelOutput.hpp"
+#endif
 
 #include <Adafruit_NeoPixel.h>
 #include <ArduinoJson.h>
+#include <functional>
+#include <queue>
 
 namespace IotZoo
 {
@@ -26,15 +33,83 @@ namespace IotZoo
     {
         int           PixelId            = 0;
         unsigned long MillisUntilTurnOff = 0;
+        uint8_t       Brightness         = 255; // applied when the frame is encoded, 255 is full
     };
 
+    /// @brief Entry of the timeout heap. It is stale if the pixel got another MillisUntilTurnOff meanwhile.
+    struct PixelTimeout
+    {
+        unsigned long MillisUntilTurnOff = 0;
+        uint16_t      PixelId            = 0;
+
+        bool operator>(const PixelTimeout& other) const
+        {
+            return MillisUntilTurnOff > other.MillisUntilTurnOff;
+        }
+    };
+
+    /// @brief LED strip. Setting pixels only changes the buffer and marks it dirty, loop() sends it to the strip at most
+    ///        maxFps times per second. While nothing changes and no pixel times out, loop() does nothing.
+    ///        colors holds the pixels as set, each pixel has its own brightness. Before a frame is sent, the changed pixels
+    ///        are encoded into the buffer of Adafruit_NeoPixel: scaled by their brightness and optionally gamma corrected.
+    ///        With USE_WS2818_RMT they are sent by RmtPixelOutput in the background, otherwise by Adafruit_NeoPixel::show(),
+    ///        which blocks the CPU and the interrupts.
     class WS2818 : public DeviceBase
     {
       protected:
-        Adafruit_NeoPixel*    pixels = nullptr;
+        static const uint8_t       DefaultMaxFps      = 50;
+        static constexpr int       MaxFpsLimit        = 1000; // frameIntervalMs is at least 1 ms, constexpr: std::clamp() takes a reference
+        static const unsigned long IdleIntervalMs     = 1000; // changes wake loop() up with requestLoop()
+        static const uint8_t       FrameFormatRgb     = 0;
+        static const uint8_t       FrameFormatPalette = 1;
+        static const uint8_t       FrameFormatRle     = 0x80;
+
+        Adafruit_NeoPixel*    pixels = nullptr; // the encoded frame, never uses Adafruit_NeoPixel::setBrightness()
         int                   dioPin;
         uint                  numberOfLeds;
         vector<PixelProperty> pixelProperties;
+        vector<uint32_t>      colors; // 0xRRGGBB of each pixel, without brightness
+        bool                  gammaCorrection = false;
+
+        // pixels to turn off, the earliest on top
+        std::priority_queue<PixelTimeout, vector<PixelTimeout>, std::greater<PixelTimeout>> timeouts;
+
+        bool          dirty           = false;
+        uint16_t      dirtyFirst      = 0; // range of the pixels changed since the last show()
+        uint16_t      dirtyLast       = 0;
+        unsigned long frameIntervalMs = 1000 / DefaultMaxFps;
+        unsigned long lastShowMillis  = 0;
+
+        PixelEffects pixelEffects;
+
+        vector<uint8_t> frameBuffer; // decoded frame, kept to avoid an allocation per frame
+
+#ifdef USE_WS2818_RMT
+        static const size_t BytesPerPixel = 3; // NEO_GRB
+
+        RmtPixelOutput* output = nullptr;
+
+        /// @brief Called in the RMT interrupt, lets the scheduler call loop() for the next frame.
+        static void onFrameSent(void* arg);
+#endif
+
+        /// @brief Writes the pixels from first to last into the buffer of Adafruit_NeoPixel, with brightness and gamma.
+        void encode(uint16_t first, uint16_t last);
+
+        /// @brief Sends the pixels to the strip.
+        /// @return false if the strip is still busy with the previous frame.
+        bool show();
+
+        /// @brief Marks the pixels from first to last as changed and lets the scheduler call loop() unless it is called by loop().
+        void markDirty(uint16_t first, uint16_t last, bool wakeUp = true);
+
+        /// @brief Turns off the pixels whose time is up.
+        void turnOffExpiredPixels(unsigned long now);
+
+        /// @brief Reads a property of an effect into number. A value outside min ... max, negative ones included, is not
+        ///        truncated: an error is published instead.
+        /// @return false if the value is out of range.
+        bool getEffectProperty(JsonVariantConst property, const char* name, uint32_t min, uint32_t max, uint32_t& number);
 
       public:
         WS2818(int deviceIndex, Settings* const settings, MqttClient* const mqttClient, const String& baseTopic, uint pin, uint numberOfLeds);
@@ -45,12 +120,50 @@ namespace IotZoo
 
         void loop() override;
 
+        /// @brief Milliseconds until the next frame may be shown or the next pixel times out.
+        unsigned long getLoopIntervalMs() const override;
+
+        /// @brief Limits how often the strip is refreshed. Sending 256 pixels takes 7.7 ms with the interrupts disabled.
+        ///        A value outside 1 ... MaxFpsLimit is clamped and an error is published.
+        void setMaxFps(int maxFps);
+
+        /// @brief Corrects the colors with GammaTable, so that dark colors and color mixtures look right. Off by default.
+        void setGammaCorrection(bool on);
+
+        /// @brief Sets the brightness of the pixels from startIndex on, without changing their colors. 0 ... 255 (full).
+        void setBrightness(uint16_t startIndex, uint16_t length, uint8_t brightness);
+
         /// @brief Example: iotzoo/esp32/08:D1:F9:E0:31:78/neo/0/setPixelColor
         /// @param json
         void setPixelColor(const String& json);
 
         void setPixelsByPreset(const String& presetName);
 
+        /// @brief Sets pixels from a binary frame, without JSON. The payload is the frame in Base64, because the MQTT client
+        ///        passes payloads as zero terminated text. Frame, little endian:
+        ///        byte 0: format, FrameFormatRgb or FrameFormatPalette, | FrameFormatRle for run length encoded data
+        ///        byte 1, 2: index of the first pixel; byte 3, 4: number of pixels
+        ///        Palette only: byte 5: number of colors (0 means 256), then r, g, b for each color
+        ///        Data: r, g, b (Rgb) or the color index (Palette) for each pixel. Run length encoded: a count (1 ... 255)
+        ///        followed by one pixel, repeated.
+        void setPixelsByFrame(const String& base64);
+
+        /// @return false and publishes an error if the frame is not valid. Then no pixel is changed.
+        bool setPixelsByFrame(const uint8_t* frame, size_t length);
+
+        /// @brief Starts or stops an effect, which is then rendered on the microcontroller.
+        ///        Example: iotzoo/esp32/08:D1:F9:E0:31:78/neo/0/effect
+        ///        {"effect": "blink", "index": 0, "length": 8, "color": "#FF0000", "color2": "#000000", "periodMs": 500, "durationMs": 10000}
+        ///        effect: fade, blink, chase, breathe, gradient, scroll or stop. periodMs: 1 ... 65535. Optional: opacity
+        ///        (0 ... 255), width (chase, 1 ... 255), brightness of the range (0 ... 255, 0 keeps it). Out of range values
+        ///        publish an error and start no effect.
+        void startEffect(const String& json);
+
+        /// @return false if too many effects are running.
+        bool startEffect(const PixelEffect& effect);
+
+        void stopEffects();
+
         /// @brief Let the user know what the device can do.
         /// @param topics
         void addMqttTopicsToRegister(std::vector<Topic>* const topics) const override;
@@ -64,6 +177,7 @@ namespace IotZoo
         void setPixelColorRgb(uint8_t r, uint8_t g, uint8_t b, uint16_t startIndex, uint16_t length, uint8_t brightness = 20,
                               uint64_t millisUntilTurnOff = 0);
 
+        /// @param brightness of this pixel only, 0 keeps the brightness of the pixel.
         void setPixelColor(uint32_t color, uint16_t index, uint8_t brightness = 20, uint64_t millisUntilTurnOff = 0);
         void setPixelColor(uint32_t color, uint16_t startIndex, uint16_t length, uint8_t brightness = 20, uint64_t millisUntilTurnOff = 0);
 
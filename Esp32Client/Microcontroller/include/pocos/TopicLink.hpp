@@ -1,4 +1,5 @@
 #pragma once
+#include "TopicLinkExpression.hpp"
 #include <WString.h>
 
 namespace IotZoo
@@ -6,7 +7,8 @@ namespace IotZoo
     struct TopicLink
     {
         TopicLink(const String& topic, const String& expression, const String& targetTopic, const String& targetPayload)
-            : TriggeringTopic(topic), Expression(expression), TargetTopic(targetTopic), TargetPayload(targetPayload)
+            : TriggeringTopic(topic), TargetTopic(targetTopic), Expression(expression), Condition(TopicLinkExpression::compile(expression)),
+              TargetPayload(targetPayload)
         {
             Serial.println("Constructor TopicLink. TriggeringTopic: " + TriggeringTopic +
                            ", Expression: " + Expression + ", TargetTopic: " + TargetTopic + ", TargetPayload: " + TargetPayload);
@@ -29,10 +31,23 @@ namespace IotZoo
         String TriggeringTopic; // Triggering Topic, e.g. "iotzoo/esp32/reed_contact/0/rpm"
         String TargetTopic;     // Target Topic, e.g. "iotzoo/esp32/TM1637_4/0/number"
 
-        String Expression; // json
+        String              Expression; // json
+        TopicLinkExpression Condition;  // Expression, compiled once
         // If empty or "input", the payload of the received TriggeringTopic message will be published to TargetTopic.
         String TargetPayload;
 
         String Payload; // Payload to publish to TargetTopic when Topic is received, e.g. "44.6"
+
+        float         Deadband      = 0; // Numeric values must change by more than Deadband to fire again. 0: every change fires.
+        unsigned long MinIntervalMs = 0; // Minimum time between two firings. 0: no limit.
+
+        // State of the last firing, used for Deadband and MinIntervalMs.
+        bool          HasFired        = false;
+        String        LastValue;
+        unsigned long LastFiredMillis = 0;
+
+        // Latest value that arrived within MinIntervalMs, published by DeviceBase::loop() when MinIntervalMs has passed.
+        bool   HasPending = false;
+        String PendingValue;
     };
 } // namespace IotZoo
\ No newline at end of file
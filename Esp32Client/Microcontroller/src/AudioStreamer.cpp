@@ -10,6 +10,8 @@
 #include "Defines.hpp"
 
 #ifdef USE_AUDIO_STREAMER
+#include "BinaryLog.hpp"
+#include "DebugHelper.hpp"
 #include "AudioStreamer.hpp"
 
 namespace IotZoo
@@ -48,8 +50,7 @@ namespace IotZoo
     {
         size_t bytesRead = 0;
         i2s_read(I2S_NUM_0, i2sBuffer, sizeof(i2sBuffer), &bytesRead, portMAX_DELAY);
-+
-        Serial.println("Bytes read from I2S: " + String(bytesRead));
+        logBinary("Bytes read from I2S: %u", bytesRead);
 
         int sampleCount = bytesRead / 4; // sizeof(int32_t);
 
@@ -73,7 +74,7 @@ namespace IotZoo
                 }
                 double rms    = sqrt(sumSq / CHUNK_SIZE);
                 String strRms = String(rms, 0);
-                Serial.println("RMS: " + strRms);
+                logDebug("RMS: " << strRms);
                 if (rms >= minRms)
                 {
                     /* wird schlechter
@@ -92,12 +93,12 @@ namespace IotZoo
                     }
                     if (features & AudioStreamerFeatures::SoundLevelRms)
                     {
-                        mqttClient->publish(baseTopic + "/audio_stream/" + getDeviceIdex() + "/sound_level_rms", strRms);
+                        mqttClient->publishState(baseTopic + "/audio_stream/" + getDeviceIdex() + "/sound_level_rms", strRms);
                     }
                     if (features & AudioStreamerFeatures::SoundLevelDecibel)
                     {
                         double decibel = rmsToDecibel(rms);
-                        mqttClient->publish(baseTopic + "/audio_stream/" + getDeviceIdex() + "/sound_level_decibel", String(decibel, 0));
+                        mqttClient->publishState(baseTopic + "/audio_stream/" + getDeviceIdex() + "/sound_level_decibel", String(decibel, 0));
                     }
                 }
                 bufferIndex = 0; // collect next chunk.
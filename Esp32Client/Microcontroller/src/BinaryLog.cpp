@@ -0,0 +1,112 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Binary log: records the address of the format string and the raw arguments, formatting happens on the host.
+// --------------------------------------------------------------------------------------------------------------------
+#include "Defines.hpp"
+
+#ifdef USE_BINARY_LOG
+#include "BinaryLog.hpp"
+
+namespace IotZoo
+{
+    BinaryLog binaryLog;
+
+    void BinaryLog::append(const char* format, const uint32_t* arguments, uint8_t count)
+    {
+        const size_t words = HeaderWords + count;
+
+        portENTER_CRITICAL_SAFE(&lock);
+        if (CapacityWords - (head - tail) < words)
+        {
+            dropped++;
+            sequence++; // leaves a gap for the decoder
+            portEXIT_CRITICAL_SAFE(&lock);
+            return;
+        }
+        ring[head++ & (CapacityWords - 1)] = reinterpret_cast<uintptr_t>(format);
+        ring[head++ & (CapacityWords - 1)] = millis();
+        ring[head++ & (CapacityWords - 1)] = (uint32_t)count << 24 | (sequence++ & 0xFFFFFF);
+        for (uint8_t i = 0; i < count; i++)
+        {
+            ring[head++ & (CapacityWords - 1)] = arguments[i];
+        }
+        portEXIT_CRITICAL_SAFE(&lock);
+    }
+
+    size_t BinaryLog::read(uint32_t* record)
+    {
+        portENTER_CRITICAL_SAFE(&lock);
+        if (head == tail)
+        {
+            portEXIT_CRITICAL_SAFE(&lock);
+            return 0;
+        }
+        size_t words = HeaderWords + (ring[(tail + 2) & (CapacityWords - 1)] >> 24);
+        for (size_t i = 0; i < words; i++)
+        {
+            record[i] = ring[tail++ & (CapacityWords - 1)];
+        }
+        portEXIT_CRITICAL_SAFE(&lock);
+        return words;
+    }
+
+    size_t BinaryLog::read(uint8_t* buffer, size_t size)
+    {
+        size_t length = 0;
+        while (length + MaxRecordWords * sizeof(uint32_t) <= size)
+        {
+            uint32_t record[MaxRecordWords];
+            size_t   words = read(record);
+            if (words == 0)
+            {
+                break;
+            }
+            memcpy(buffer + length, record, words * sizeof(uint32_t)); // the ESP32 is little endian
+            length += words * sizeof(uint32_t);
+        }
+        return length;
+    }
+
+    void BinaryLog::beginSerialOutput()
+    {
+        // Priority 0 like the idle task: runs only when nothing else wants the core.
+        xTaskCreate(serialOutputTask, "BinaryLog", 2048, this, tskIDLE_PRIORITY, nullptr);
+    }
+
+    void BinaryLog::serialOutputTask(void* parameter)
+    {
+        static const char hexDigits[] = "0123456789abcdef";
+
+        BinaryLog* binaryLog = static_cast<BinaryLog*>(parameter);
+        uint32_t   record[MaxRecordWords];
+        char       line[3 + MaxRecordWords * 8 + 2];
+        for (;;)
+        {
+            size_t words;
+            while ((words = binaryLog->read(record)) > 0)
+            {
+                size_t         length = 0;
+                const uint8_t* bytes  = reinterpret_cast<const uint8_t*>(record);
+                line[length++]        = '#';
+                line[length++]        = 'L';
+                line[length++]        = ' ';
+                for (size_t i = 0; i < words * sizeof(uint32_t); i++)
+                {
+                    line[length++] = hexDigits[bytes[i] >> 4];
+                    line[length++] = hexDigits[bytes[i] & 0x0F];
+                }
+                line[length++] = '\r';
+                line[length++] = '\n';
+                Serial.write(reinterpret_cast<const uint8_t*>(line), length);
+            }
+            vTaskDelay(pdMS_TO_TICKS(OutputIntervalMs));
+        }
+    }
+} // namespace IotZoo
+#endif // USE_BINARY_LOG
@@ -10,6 +10,7 @@
 // --------------------------------------------------------------------------------------------------------------------
 #include "Defines.hpp"
 #ifdef USE_KEYPAD
+#include "DebugHelper.hpp"
 #include "ButtonMatrix.hpp"
 
 #include <Arduino.h>
@@ -21,6 +22,9 @@ namespace IotZoo
     {
         keyMap       = makeKeymap(hexaKeys);
         customKeypad = new Keypad(keyMap, rowPins, colPins, ROWS, COLS);
+
+        topicButtonPrefix = getBaseTopic() + "/button_matrix/" + String(deviceIndex) + "/button/";
+        topicButton.reserve(topicButtonPrefix.length() + 10);
     }
 
     ButtonMatrix::~ButtonMatrix()
@@ -56,12 +60,21 @@ namespace IotZoo
         }
     }
 
+    void ButtonMatrix::publishKeyState(char key, const char* state, const char* subTopic)
+    {
+        topicButton = topicButtonPrefix;
+        topicButton += key;
+        mqttClient->publish(topicButton, state);
+        topicButton += subTopic;
+        mqttClient->publish(topicButton, String(millis()));
+    }
+
     void ButtonMatrix::loop()
     {
         String msg;
         if (getCustomKeypad()->getKeys())
         {
-            Serial.println("get keys...");
+            logDebug("get keys...");
             for (int i = 0; i < LIST_MAX; i++) // Scan the whole key list.
             {
                 if (getCustomKeypad()->key[i].stateChanged) // Only find keys that have changed state.
@@ -74,10 +87,7 @@ namespace IotZoo
                         msg     = " PRESSED.";
                         Key key = getCustomKeypad()->key[i];
 #ifdef USE_MQTT
-                        String topicButton = getBaseTopic() + "/button_matrix/" + String(getDeviceIndex()) + "/button/" + String(key.kchar);
-                        mqttClient->publish(topicButton, "PRESSED");
-                        topicButton = getBaseTopic() + "/button_matrix/" + String(getDeviceIndex()) + "/button/" + String(key.kchar) + "/pressed";
-                        mqttClient->publish(topicButton, String(millis()));
+                        publishKeyState(key.kchar, "PRESSED", "/pressed");
 #endif
                     }
                     break;
@@ -86,10 +96,7 @@ namespace IotZoo
                         msg     = " HOLD.";
                         Key key = getCustomKeypad()->key[i];
 #ifdef USE_MQTT
-                        String topicButton = getBaseTopic() + "/button_matrix/" + String(getDeviceIndex()) + "/button/" + String(key.kchar);
-                        mqttClient->publish(topicButton, "HOLD");
-                        topicButton = getBaseTopic() + "/button_matrix/" + String(getDeviceIndex()) + "/button/" + String(key.kchar) + "/hold";
-                        mqttClient->publish(topicButton, String(millis()));
+                        publishKeyState(key.kchar, "HOLD", "/hold");
 #endif
                     }
                     break;
@@ -98,10 +105,7 @@ namespace IotZoo
                         msg     = " RELEASED.";
                         Key key = getCustomKeypad()->key[i];
 #ifdef USE_MQTT
-                        String topicButton = getBaseTopic() + "/button_matrix/" + String(getDeviceIndex()) + "/button/" + String(key.kchar);
-                        mqttClient->publish(topicButton, "RELEASED");
-                        topicButton = getBaseTopic() + "/button_matrix/" + String(getDeviceIndex()) + "/button/" + String(key.kchar) + "/released";
-                        mqttClient->publish(topicButton, String(millis()));
+                        publishKeyState(key.kchar, "RELEASED", "/released");
 #endif
                     }
                     break;
@@ -110,9 +114,7 @@ namespace IotZoo
                         msg = " IDLE.";
                     }
                     }
-                    Serial.print("Key ");
-                    Serial.print(getCustomKeypad()->key[i].kchar);
-                    Serial.println(msg);
+                    logDebug("Key " << getCustomKeypad()->key[i].kchar << msg);
                 }
             }
         }
@@ -10,6 +10,7 @@
 // --------------------------------------------------------------------------------------------------------------------
 #include "Defines.hpp"
 #ifdef USE_DS18B20
+#include "DebugHelper.hpp"
 #include "DS18B20.hpp"
 
 namespace IotZoo
@@ -33,24 +34,29 @@ namespace IotZoo
         Serial.println("Start the DS18B20 sensor!");
         // Start the DS18B20 sensor
         dallasTemperatureSensors->begin();
-        numberOfDevices = dallasTemperatureSensors->getDeviceCount();
+        // requestTemperatures() returns at once, loop() collects the readings when the conversion time has elapsed.
+        dallasTemperatureSensors->setWaitForConversion(false);
+        conversionTimeMs = dallasTemperatureSensors->millisToWaitForConversion(resolution);
+        numberOfDevices  = dallasTemperatureSensors->getDeviceCount();
         Serial.print("Found ");
         Serial.print(numberOfDevices, DEC);
         Serial.println(" temperature sensors.");
 
         // Loop through each device, print out address
+        sensors.resize(numberOfDevices);
         for (int i = 0; i < numberOfDevices; i++)
         {
-            // We'll use this variable to store a found device address
-            DeviceAddress tempDeviceAddress;
+            Sensor& sensor      = sensors[i];
+            sensor.topicCelsius = getBaseTopic() + "/ds18b20_manager/0/sensor/" + String(i) + "/celsius";
 
             // Search the wire for address
-            if (dallasTemperatureSensors->getAddress(tempDeviceAddress, i))
+            sensor.hasAddress = dallasTemperatureSensors->getAddress(sensor.address, i);
+            if (sensor.hasAddress)
             {
                 Serial.print("Found DS18B20 temperature sensor ");
                 Serial.print(i, DEC);
                 Serial.print(" with address: ");
-                printDeviceAddress(tempDeviceAddress);
+                printDeviceAddress(sensor.address);
             }
             else
             {
@@ -98,86 +104,103 @@ namespace IotZoo
         Serial.println();
     }
 
-    std::vector<float> DS18B20::requestTemperatures()
+    std::vector<float> DS18B20::getTemperatures() const
     {
-        std::vector<float>           temperatures;
-        DallasTemperature::request_t request = dallasTemperatureSensors->requestTemperatures();
+        std::vector<float> temperatures;
+        for (const auto& sensor : sensors)
+        {
+            temperatures.push_back(sensor.celsius);
+        }
+        return temperatures;
+    }
 
-        if (request.result)
+    float DS18B20::getTemperature(const DeviceAddress address) const
+    {
+        for (const auto& sensor : sensors)
         {
-            delay(250); // Do not remove this delay!
-            for (int i = 0; i < numberOfDevices; i++)
+            if (sensor.hasAddress && memcmp(sensor.address, address, sizeof(DeviceAddress)) == 0)
             {
-                float temperatureCelsius = dallasTemperatureSensors->getTempCByIndex(i);
-                temperatures.push_back(temperatureCelsius);
+                return sensor.celsius;
             }
         }
+        return DEVICE_DISCONNECTED_C;
+    }
+
+    void DS18B20::startConversion()
+    {
+        DallasTemperature::request_t request = dallasTemperatureSensors->requestTemperatures();
+        if (request.result)
+        {
+            converting            = true;
+            conversionStartMillis = millis();
+        }
         else
         {
             Serial.println("DS18B20 is not working.");
         }
-        return temperatures;
     }
 
-    void DS18B20::loop()
+    void DS18B20::collectTemperatures()
     {
-        if (millis() - getLastPublishedTemperatureMillis() < getInterval())
+        converting = false;
+        for (auto& sensor : sensors)
         {
-            return;
+            // Reading by address avoids searching the bus for every sensor.
+            sensor.celsius = sensor.hasAddress ? dallasTemperatureSensors->getTempC(sensor.address) : DEVICE_DISCONNECTED_C;
         }
-        DeviceBase::loop();
+    }
 
-        setLastPublishedTemperatureMillis(millis());
+    unsigned long DS18B20::getLoopIntervalMs() const
+    {
+        // Keep the internal MQTT client serviced while waiting for the conversion or the interval.
+        unsigned long maxWaitMs = 100;
+        unsigned long elapsed   = millis() - (converting ? conversionStartMillis : (unsigned long)lastPublishedTemperatureMillis);
+        unsigned long duration  = converting ? conversionTimeMs : (unsigned long)interval;
+        return elapsed >= duration ? 0 : min(duration - elapsed, maxWaitMs);
+    }
 
-        std::vector<float> temperatures = requestTemperatures();
-        Serial.println("Count of Temperature sensors: " + String(temperatures.size()));
-        int indexTemperatureSensor = 0;
+    void DS18B20::loop()
+    {
+        DeviceBase::loop();
+        if (converting)
+        {
+            if (millis() - conversionStartMillis < conversionTimeMs)
+            {
+                return;
+            }
+            collectTemperatures();
+        }
+        else
+        {
+            if (millis() - getLastPublishedTemperatureMillis() >= getInterval())
+            {
+                setLastPublishedTemperatureMillis(millis());
+                startConversion();
+            }
+            return;
+        }
 
-        for (const auto& temperatureCelsius : temperatures)
+        logDebug("Count of Temperature sensors: " << sensors.size());
+        for (const auto& sensor : sensors)
         {
-            String topic = getBaseTopic() + "/ds18b20_manager/0/sensor/" + String(indexTemperatureSensor) + "/celsius";
+            const String& topic = sensor.topicCelsius;
 
-            Serial.print(topic + "/" + String(temperatureCelsius));
-            Serial.println(" ºC");
-            if (temperatureCelsius != DEVICE_DISCONNECTED_C)
+            logDebug(topic << "/" << sensor.celsius << " ºC");
+            if (sensor.celsius != DEVICE_DISCONNECTED_C)
             {
-                mqttClient->publish(topic, String(temperatureCelsius, 1));
+                String value = String(sensor.celsius, 1);
+                mqttClient->publishState(topic, value);
+#ifdef USE_INTERNAL_MQTT
+                signalValueChanged(topic, value);
+#endif
             }
             else
             {
                 mqttClient->publish(topic, "device is not ready");
             }
-            indexTemperatureSensor++;
         }
     }
 
-    bool DS18B20::setPayloadPropertyOfTopicLink(TopicLink& topicLink)
-    {
-        debug("DS18B20::setPayloadPropertyOfTopicLink. TriggeringTopic: " + topicLink.TriggeringTopic);
-
-        bool handled = DeviceBase::setPayloadPropertyOfTopicLink(topicLink);
-        if (!handled && topicLink.TriggeringTopic.equalsIgnoreCase(getBaseTopic() + "/ds18b20_manager/0/sensor/" + String(getDeviceIndex()) + "/celsius"))
-        {
-            std::vector<float> temperatures = requestTemperatures();
-            topicLink.Payload               = String(temperatures[0], 1);
-            debug("DS18B20::setPayloadPropertyOfTopicLink. TriggeringTopic matches the temperature topic! Setting Payload to the current temperature value: " + topicLink.Payload          + " topicLink.TargetTopic: " + topicLink.TargetTopic);
-            handled                         = true;
-        }
-        else
-        {
-            debug("DS18B20::setPayloadPropertyOfTopicLink. TriggeringTopic does not match the temperature topic. handled: " + String(handled) + ", topicLink.TriggeringTopic: " + topicLink.TriggeringTopic + ", expected: " + getBaseTopic() + "/ds18b20_manager/" + String(getDeviceIndex()) + "/celsius" );
-        }
-        debug("DS18B20::setPayloadPropertyOfTopicLink. topicLink.TriggeringTopic: " + topicLink.TriggeringTopic + ", topicLink.TargetTopic: " + topicLink.TargetTopic + ", topicLink.Payload: " + topicLink.Payload + ", handled: " + String(handled));
-
-        return handled;
-    }
-
-    void DS18B20::publishInternalMqtt()
-    {
-        debug("DS18B20::publishInternalMqtt. Count of TopicLinks: " + String(TopicLinks.size()));
-        DeviceBase::publishInternalMqtt();
-    }
-
 } // namespace IotZoo
 
 #endif // USE_DS18B20
\ No newline at end of file
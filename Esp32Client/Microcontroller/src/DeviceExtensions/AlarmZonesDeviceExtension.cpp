@@ -17,299 +17,221 @@
 #include "DeviceBase.hpp"
 #include "PixelMatrix.hpp"
 
+#include <algorithm>
+
 namespace IotZoo
 {
-    AlarmZonesDeviceExtension::AlarmZonesDeviceExtension(DeviceBase* const deviceBase) : DeviceExtension(deviceBase)
-    {
-        Serial.println("Constructor AlarmZonesDeviceExtension");
-    }
+    // Built-in tables, used if there is no "alarm_zones" in the settings. The explicit colors come first, they win over
+    // what was detected.
+    static const char* DefaultColors = R"([
+        {"name": "orange", "color": "#FFA500"}, {"name": "blue", "color": "#0000FF"}, {"name": "purple", "color": "#800080"},
+        {"name": "lightblue", "color": "#ADD8E6"}, {"name": "lemon", "color": "#FFFFE0"}, {"name": "mint", "color": "#98FB98"},
+        {"name": "green", "color": "#00FF00"}, {"name": "red", "color": "#FF0000"}, {"name": "white", "color": "#FFFFFF"},
+        {"name": "motion", "color": "#FFAF00", "brightness": 4}, {"name": "animal", "color": "#00FF00", "brightness": 8},
+        {"name": "vehicle", "color": "#0000FF", "brightness": 12}, {"name": "person", "color": "#FF0000", "brightness": 16},
+        {"name": "rang", "color": "#800080", "brightness": 20}])";
 
-    void AlarmZonesDeviceExtension::onMqttConnectionEstablished()
-    {
-        String topic = deviceBase->getBaseTopic() + "/" + deviceBase->getDeviceName() + "/" + String(deviceBase->getDeviceIndex()) + "/alarm";
-        deviceBase->getMqttClient()->subscribe(topic, [&](const String& json) { onAlarmReceived(json); });
-        Serial.println("PixelMatrix subscribed to topic " + topic);
-    }
+    static const char* DefaultZones8x8 = R"([
+        {"name": "dachboden", "spans": [[27, 3], [34, 3]]},
+        {"name": "schuppen", "spans": [[51, 3], [58, 3]]},
+        {"name": "vorne", "spans": [[0, 3], [13, 3], [16, 3], [29, 3]]},
+        {"name": "hinten", "spans": [[21, 1], [26, 1], [37, 1], [42, 1]]},
+        {"name": "terrasse", "spans": [[2, 3], [11, 3], [18, 3]]},
+        {"name": "parkplatz", "spans": [[32, 4], [44, 4], [48, 4], [60, 4]]},
+        {"name": "garten", "spans": [[42, 2], [52, 2], [58, 2]]},
+        {"name": "westen", "spans": [[52, 3], [41, 3], [36, 3], [25, 3]]},
+        {"name": "osten", "spans": [[21, 3], [24, 3], [37, 3], [40, 3], [52, 4], [56, 4]]},
+        {"name": "feld", "spans": [[7, 1], [8, 1], [23, 1], [24, 1], [39, 1], [40, 1], [55, 1], [56, 1]]},
+        {"name": "klingel", "spans": [[4, 3]]}])";
 
-    /// @brief Let the user know what the device can do.
-    /// @param topics
-    void AlarmZonesDeviceExtension::addMqttTopicsToRegister(std::vector<Topic>* const topics) const
-    {
-        topics->emplace_back(deviceBase->getBaseTopic() + "/" + deviceBase->getDeviceName() + "/" + String(deviceBase->getDeviceIndex()) + "/alarm",
-                             "{ \"zone\":\"cam1\", \"level\": 1}", MessageDirection::IotZooClientOutbound);
-    }
+    static const char* DefaultZones16x16 = R"([
+        {"name": "dachboden", "spans": [[102, 4], [118, 4], [134, 4], [150, 4], [166, 4], [182, 4]]},
+        {"name": "schuppen", "spans": [[93, 3], [96, 3], [125, 3], [128, 3], [157, 3]]},
+        {"name": "garten", "spans": [[128, 3], [157, 3], [160, 3]]},
+        {"name": "vorne", "spans": [[6, 10], [16, 9], [40, 8]]},
+        {"name": "hinten", "spans": [[146, 12], [162, 12], [178, 12]]},
+        {"name": "terrasse", "spans": [[77, 3], [80, 3], [109, 3], [112, 3], [141, 3]]},
+        {"name": "parkplatz", "spans": [[0, 4], [28, 4], [32, 4], [60, 4], [64, 4]]},
+        {"name": "westen", "spans": [[161, 8], [183, 8], [193, 8], [215, 8], [225, 8]]},
+        {"name": "osten", "spans": [[168, 6], [178, 6], [200, 6], [210, 6], [232, 6], [242, 6]]},
+        {"name": "feld", "spans": [[240, 16]]},
+        {"name": "klingel", "spans": [[6, 5], [21, 5]]}])";
 
-    uint AlarmZonesDeviceExtension::getAlarmLevel(const String& subject)
+    AlarmZonesDeviceExtension::AlarmZonesDeviceExtension(DeviceBase* const deviceBase) : DeviceExtension(deviceBase)
     {
-        uint level = 0;
-        if (subject.indexOf("motion") > -1) // yellow
-        {
-            level = 1;
-        }
-        else if (subject.indexOf("animal") > -1) // green
-        {
-            level = 2;
-        }
-        else if (subject.indexOf("vehicle") > -1) // blue
-        {
-            level = 3;
-        }
-        else if (subject.indexOf("person") > -1) // red
-        {
-            level = 4;
-        }
-        else if (subject.indexOf("rang") > -1) // purple
-        {
-            level = 5;
-        }
-        Serial.println("level: " + String(level));
-        return level;
+        Serial.println("Constructor AlarmZonesDeviceExtension");
+        loadTables();
     }
 
-    void AlarmZonesDeviceExtension::onAlarmReceived(const String& subject)
+    void AlarmZonesDeviceExtension::loadTables()
     {
-        Serial.println("onAlarmReceived subject: " + subject);
-        String subjectLocal = subject;
-        subjectLocal.toLowerCase();
+        PixelMatrix* pixelMatrix  = (PixelMatrix*)deviceBase;
+        uint         columns      = pixelMatrix->GetNumberOfLedsPerColumn();
+        uint         rows         = pixelMatrix->GetNumberOfLedsPerRow();
+        uint16_t     numberOfLeds = columns * rows;
 
-        u32_t        color              = 0;
-        u32_t        millisUntilTurnOff = 60000;
-        uint         brightness         = 4;
-        PixelMatrix* pixelMatrix        = (PixelMatrix*)deviceBase;
-        if (subjectLocal.indexOf("orange") > -1)
+        String json;
+        if (nullptr != deviceBase->getSettings())
         {
-            color = 0xFFA500; // orange
+            json = deviceBase->getSettings()->loadConfiguration(SettingsKey);
         }
-        else if (subjectLocal.indexOf("blue") > -1)
-        {
-            color = 0x0000FF; // blue
-        }
-        else if (subjectLocal.indexOf("purple") > -1)
+
+        DynamicJsonDocument jsonDocument(8192); // on heap, only at startup
+        JsonArrayConst      colorElements;
+        JsonArrayConst      zoneElements;
+        if (json.length() > 0)
         {
-            color = 0x800080; // purple
+            DeserializationError error = deserializeJson(jsonDocument, json);
+            if (error)
+            {
+                Serial.println("AlarmZones: settings " + String(SettingsKey) + " invalid: " + String(error.c_str()));
+            }
+            else
+            {
+                colorElements = jsonDocument["colors"].as<JsonArrayConst>();
+                zoneElements  = jsonDocument["zones"].as<JsonArrayConst>();
+                if (jsonDocument["millisUntilTurnOff"] != nullptr)
+                {
+                    millisUntilTurnOff = jsonDocument["millisUntilTurnOff"].as<unsigned long>();
+                }
+            }
         }
-        else if (subjectLocal.indexOf("lightblue") > -1)
+
+        // Parsed one after the other, the document of the settings is still needed.
+        if (colorElements.isNull())
         {
-            color = 0xADD8E6; // light blue
+            DynamicJsonDocument defaults(2048);
+            deserializeJson(defaults, DefaultColors);
+            loadColors(defaults.as<JsonArrayConst>());
         }
-         else if (subjectLocal.indexOf("lemon") > -1)
+        else
         {
-            color = 0xFFFFE0; // lemon yellow
-        }
-         else if (subjectLocal.indexOf("mint") > -1)
-        {   
-            color = 0x98FB98; // mint
+            loadColors(colorElements);
         }
-        else if (subjectLocal.indexOf("green") > -1)
+
+        const char* defaultZones = columns == 8 && rows == 8 ? DefaultZones8x8 : columns == 16 && rows == 16 ? DefaultZones16x16 : "[]";
+        if (zoneElements.isNull())
         {
-            color = 0x00FF00; // green
+            DynamicJsonDocument defaults(4096);
+            deserializeJson(defaults, defaultZones);
+            loadZones(defaults.as<JsonArrayConst>(), numberOfLeds);
         }
-        else if (subjectLocal.indexOf("red") > -1)
+        else
         {
-            color = 0xFF0000; // red
+            loadZones(zoneElements, numberOfLeds);
         }
-        else if (subjectLocal.indexOf("white") > -1)
+        if (zones.find("all") == zones.end())
         {
-            color = 0xFFFFFF; // white
+            zones["all"].push_back({0, numberOfLeds});
         }
-        else
+        Serial.println("AlarmZones: " + String(colors.size()) + " colors, " + String(zones.size()) + " zones");
+    }
+
+    void AlarmZonesDeviceExtension::loadColors(JsonArrayConst elements)
+    {
+        uint16_t priority = 0;
+        for (JsonVariantConst element : elements)
         {
-            uint level = getAlarmLevel(subjectLocal);
-            if (level == 1)
-            {
-                color = pixelMatrix->getPixels()->Color(255, 175, 0); // motion -> yellow/orange
-            }
-            else if (level == 2)
-            {
-                color = pixelMatrix->getPixels()->Color(0, 255, 0); // animal -> green
-            }
-            else if (level == 3)
-            {
-                color = pixelMatrix->getPixels()->Color(0, 0, 255); // vehicle -> blue
-            }
-            else if (level == 4)
+            String name = element["name"].as<String>();
+            String hex  = element["color"].as<String>();
+            if (hex.startsWith("#"))
             {
-                color = pixelMatrix->getPixels()->Color(255, 0, 0); // person -> red
+                hex = hex.substring(1);
             }
-            else if (level == 5)
+            name.toLowerCase();
+
+            AlarmColor color;
+            color.Color    = strtoul(hex.c_str(), nullptr, 16);
+            color.Priority = priority++;
+            if (element["brightness"] != nullptr)
             {
-                color = pixelMatrix->getPixels()->Color(128, 0, 128); // alarm rang -> purple
+                color.Brightness = element["brightness"].as<uint8_t>();
             }
-            brightness = level * 4;
+            colors[name.c_str()] = color;
         }
+    }
 
-        if (color == 0)
+    void AlarmZonesDeviceExtension::loadZones(JsonArrayConst elements, uint16_t numberOfLeds)
+    {
+        for (JsonVariantConst element : elements)
         {
-            return;
+            String name = element["name"].as<String>();
+            name.toLowerCase();
+            std::vector<AlarmZoneSpan>& spans = zones[name.c_str()];
+            for (JsonVariantConst span : element["spans"].as<JsonArrayConst>())
+            {
+                uint16_t startIndex = span[0].as<uint16_t>();
+                uint16_t length     = span[1].as<uint16_t>();
+                if (startIndex >= numberOfLeds || length == 0)
+                {
+                    Serial.println("AlarmZones: span of zone " + name + " out of range");
+                    continue;
+                }
+                spans.push_back({startIndex, (uint16_t)std::min<uint32_t>(length, numberOfLeds - startIndex)});
+            }
         }
+    }
 
-        if (subjectLocal.indexOf("all") > -1)
-        {
-            pixelMatrix->setPixelColor(color, 0, pixelMatrix->GetNumberOfLedsPerColumn() * pixelMatrix->GetNumberOfLedsPerRow(), brightness,
-                                       millisUntilTurnOff);
-            return;
-        }
+    void AlarmZonesDeviceExtension::onMqttConnectionEstablished()
+    {
+        String topic = deviceBase->getBaseTopic() + "/" + deviceBase->getDeviceName() + "/" + String(deviceBase->getDeviceIndex()) + "/alarm";
+        deviceBase->getMqttClient()->subscribe(topic, [&](const String& json) { onAlarmReceived(json); });
+        Serial.println("PixelMatrix subscribed to topic " + topic);
+    }
+
+    /// @brief Let the user know what the device can do.
+    /// @param topics
+    void AlarmZonesDeviceExtension::addMqttTopicsToRegister(std::vector<Topic>* const topics) const
+    {
+        topics->emplace_back(deviceBase->getBaseTopic() + "/" + deviceBase->getDeviceName() + "/" + String(deviceBase->getDeviceIndex()) + "/alarm",
+                             "Person Dachboden", MessageDirection::IotZooClientOutbound);
+    }
 
-        if (pixelMatrix->GetNumberOfLedsPerColumn() == 8 && pixelMatrix->GetNumberOfLedsPerRow() == 8)
+    void AlarmZonesDeviceExtension::onAlarmReceived(const String& subject)
+    {
+        Serial.println("onAlarmReceived subject: " + subject);
+
+        // Of the words naming a color the one with the lowest priority counts, of the words naming a zone the first one.
+        const AlarmColor*                 color = nullptr;
+        const std::vector<AlarmZoneSpan>* spans = nullptr;
+        std::string                       word;
+        for (size_t index = 0; index <= subject.length(); index++)
         {
-            if (subjectLocal.indexOf("dachboden") > -1)
-            {
-                pixelMatrix->setPixelColor(color, 27, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 34, 3, brightness, millisUntilTurnOff);
-            }
-            else if (subjectLocal.indexOf("schuppen") > -1)
-            {
-                pixelMatrix->setPixelColor(color, 51, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 58, 3, brightness, millisUntilTurnOff);
-            }
-            else if (subjectLocal.indexOf("vorne") > -1)
-            {
-                pixelMatrix->setPixelColor(color, 0, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 13, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 16, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 29, 3, brightness, millisUntilTurnOff);
-            }
-            else if (subjectLocal.indexOf("hinten") > -1)
-            {
-                pixelMatrix->setPixelColor(color, 21, 1, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 26, 1, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 37, 1, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 42, 1, brightness, millisUntilTurnOff);
-            }
-            else if (subjectLocal.indexOf("terrasse") > -1)
-            {
-                pixelMatrix->setPixelColor(color, 2, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 11, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 18, 3, brightness, millisUntilTurnOff);
-            }
-            else if (subjectLocal.indexOf("parkplatz") > -1)
-            {
-                pixelMatrix->setPixelColor(color, 32, 4, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 44, 4, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 48, 4, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 60, 4, brightness, millisUntilTurnOff);
-            }
-            else if (subjectLocal.indexOf("garten") > -1)
-            {
-                pixelMatrix->setPixelColor(color, 42, 2, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 52, 2, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 58, 2, brightness, millisUntilTurnOff);
-            }
-            else if (subjectLocal.indexOf("westen") > -1)
+            uint8_t character = index < subject.length() ? subject[index] : ' ';
+            if (character >= 0x80 || isalnum(character)) // also UTF-8 umlauts
             {
-                pixelMatrix->setPixelColor(color, 52, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 41, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 36, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 25, 3, brightness, millisUntilTurnOff);
+                word += (char)tolower(character);
+                continue;
             }
-            else if (subjectLocal.indexOf("osten") > -1)
+            if (word.empty())
             {
-                pixelMatrix->setPixelColor(color, 21, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 24, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 37, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 40, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 52, 4, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 56, 4, brightness, millisUntilTurnOff);
+                continue;
             }
-            else if (subjectLocal.indexOf("feld") > -1)
+            auto foundColor = colors.find(word);
+            if (foundColor != colors.end() && (nullptr == color || foundColor->second.Priority < color->Priority))
             {
-                pixelMatrix->setPixelColor(color, 7, 1, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 8, 1, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 23, 1, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 24, 1, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 39, 1, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 40, 1, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 55, 1, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 56, 1, brightness, millisUntilTurnOff);
+                color = &foundColor->second;
             }
-            else if (subjectLocal.indexOf("klingel") > -1)
+            if (nullptr == spans)
             {
-                pixelMatrix->setPixelColor(color, 4, 3, brightness, millisUntilTurnOff);
+                auto foundZone = zones.find(word);
+                spans          = foundZone == zones.end() ? nullptr : &foundZone->second;
             }
+            word.clear();
         }
-        else if (pixelMatrix->GetNumberOfLedsPerColumn() == 16 && pixelMatrix->GetNumberOfLedsPerRow() == 16)
+
+        if (nullptr == color || nullptr == spans || color->Color == 0)
         {
-            if (subjectLocal.indexOf("dachboden") > -1)
-            {
-                pixelMatrix->setPixelColor(color, 102, 4, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 118, 4, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 134, 4, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 150, 4, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 166, 4, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 182, 4, brightness, millisUntilTurnOff);
-            }
-            else if (subjectLocal.indexOf("schuppen") > -1)
-            {
-                pixelMatrix->setPixelColor(color, 93, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 96, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 125, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 128, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 157, 3, brightness, millisUntilTurnOff);
-            }
-            else if (subjectLocal.indexOf("garten") > -1)
-            {
-                pixelMatrix->setPixelColor(color, 128, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 157, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 160, 3, brightness, millisUntilTurnOff);
-            }
-            else if (subjectLocal.indexOf("vorne") > -1)
-            {
-                pixelMatrix->setPixelColor(color, 6, 10, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 16, 9, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 40, 8, brightness, millisUntilTurnOff);
-            }
-            else if (subjectLocal.indexOf("hinten") > -1)
-            {
-                pixelMatrix->setPixelColor(color, 146, 12, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 162, 12, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 178, 12, brightness, millisUntilTurnOff);
-            }
-            else if (subjectLocal.indexOf("terrasse") > -1)
-            {
-                pixelMatrix->setPixelColor(color, 77, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 80, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 109, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 112, 3, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 141, 3, brightness, millisUntilTurnOff);
-            }
-            else if (subjectLocal.indexOf("parkplatz") > -1)
-            {
-                pixelMatrix->setPixelColor(color, 0, 4, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 28, 4, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 32, 4, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 60, 4, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 64, 4, brightness, millisUntilTurnOff);
-            }
-            else if (subjectLocal.indexOf("westen") > -1)
-            {
-                pixelMatrix->setPixelColor(color, 161, 8, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 183, 8, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 193, 8, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 215, 8, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 225, 8, brightness, millisUntilTurnOff);
-            }
-            else if (subjectLocal.indexOf("osten") > -1)
-            {
-                pixelMatrix->setPixelColor(color, 168, 6, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 178, 6, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 200, 6, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 210, 6, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 232, 6, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 242, 6, brightness, millisUntilTurnOff);
-            }
-            else if (subjectLocal.indexOf("feld") > -1)
-            {
-                pixelMatrix->setPixelColor(color, 240, 16, brightness, millisUntilTurnOff);
-            }
-            else if (subjectLocal.indexOf("klingel") > -1)
-            {
-                pixelMatrix->setPixelColor(color, 6, 5, brightness, millisUntilTurnOff);
-                pixelMatrix->setPixelColor(color, 21, 5, brightness, millisUntilTurnOff);
-            }
+            return;
+        }
+
+        PixelMatrix* pixelMatrix = (PixelMatrix*)deviceBase;
+        for (const AlarmZoneSpan& span : *spans)
+        {
+            pixelMatrix->setPixelColor(color->Color, span.StartIndex, span.Length, color->Brightness, millisUntilTurnOff);
         }
-        pixelMatrix->getPixels()->show();
     }
 } // namespace IotZoo
 
 #endif // USE_WS2818
-#endif // USE_WS2818_PIXEL_MATRIX
\ No newline at end of file
+#endif // USE_WS2818_PIXEL_MATRIX
@@ -15,20 +15,27 @@
 namespace IotZoo
 {
     Gps::Gps(int deviceIndex, Settings* const settings, MqttClient* const mqttClient, const String& baseTopic, uint8_t pinRx, uint8_t pinTx,
-             uint32_t baud)
+             uint32_t baud, unsigned long publishIntervalMs)
         : DeviceBase(deviceIndex, settings, mqttClient, baseTopic)
     {
-        Serial.println("Constructor Gps. pinRx: " + String(pinRx) + ", pinTx: " + String(pinTx) + ", baud: " + String(baud));
-        this->pinRx    = pinRx;
-        this->pinTx    = pinTx;
-        softwareSerial = new SoftwareSerial(pinRx, pinTx);
-        softwareSerial->begin(baud);
+        Serial.println("Constructor Gps. pinRx: " + String(pinRx) + ", pinTx: " + String(pinTx) + ", baud: " + String(baud) +
+                       ", publishIntervalMs: " + String(publishIntervalMs));
+        this->pinRx             = pinRx;
+        this->pinTx             = pinTx;
+        this->publishIntervalMs = publishIntervalMs;
+        topicPosition           = getBaseTopic() + "/gps/position" + String(deviceIndex);
+
+        serial->setRxBufferSize(1024);
+        // Called by the uart event task when data has arrived, so NMEA is parsed without polling in loop().
+        serial->onReceive([this]() { onReceive(); });
+        serial->begin(baud, SERIAL_8N1, pinRx, pinTx);
     }
 
     Gps::~Gps()
     {
-        Serial.println("Constructor Gps");
-        delete softwareSerial;
+        Serial.println("Destructor Gps");
+        serial->onReceive(nullptr);
+        serial->end();
     }
 
     /// @brief Let the user know what the device can do.
@@ -37,49 +44,91 @@ namespace IotZoo
     {
         String examplePayload = "{\"lat\": 52.63, \"lon\": 9.61, \"alt\": 32.1, \"dateTimeUtc\": \"2025-10-05 17:30:36\"}";
 
-        topics->emplace_back(getBaseTopic() + "/gps/position" + String(deviceIndex), examplePayload, MessageDirection::IotZooClientInbound);
+        topics->emplace_back(topicPosition, examplePayload, MessageDirection::IotZooClientInbound);
     }
 
-    void Gps::loop()
+    void Gps::onReceive()
     {
-        smartDelay(1000);
-
-        if (millis() > 5000 && gps.charsProcessed() < 10)
+        uint8_t buffer[128];
+        size_t  length;
+        while (serial->available() && (length = serial->read(buffer, sizeof(buffer))) > 0)
         {
-            Serial.println(F("No GPS data received: check wiring"));
+            encode(buffer, length);
         }
+    }
 
-        if (gps.location.isValid())
+    void Gps::encode(const uint8_t* data, size_t length)
+    {
+        bytesReceived += length;
+        for (size_t i = 0; i < length; i++)
         {
-            String payload = "{ \"Lat\": " + String(gps.location.lat(), 3U) + ", \"Lon\": " + String(gps.location.lng(), 3U) +
-                             ", \"Alt\": " + String(gps.altitude.meters(), 1U);
-
-            if (gps.date.isValid() && gps.time.isValid())
+            if (!gps.encode(data[i]) || !gps.location.isUpdated() || !gps.location.isValid())
             {
-                char sz[64] = {};
-                sprintf(sz, "%02d-%02d-%02d %02d:%02d:%02d", gps.date.year(), gps.date.month(), gps.date.day(), gps.time.hour(), gps.time.minute(),
-                        gps.time.second());
-                payload += ", \"DateTimeUtc\": \"" + String(sz) + "\"";
+                continue;
             }
-            payload += "}";
-            mqttClient->publish(getBaseTopic() + "/gps/position" + String(deviceIndex), payload);
+            Fix newFix;
+            newFix.lat         = gps.location.lat();
+            newFix.lng         = gps.location.lng();
+            newFix.alt         = gps.altitude.meters();
+            newFix.hasDateTime = gps.date.isValid() && gps.time.isValid();
+            if (newFix.hasDateTime)
+            {
+                newFix.year   = gps.date.year();
+                newFix.month  = gps.date.month();
+                newFix.day    = gps.date.day();
+                newFix.hour   = gps.time.hour();
+                newFix.minute = gps.time.minute();
+                newFix.second = gps.time.second();
+            }
+            {
+                std::lock_guard<std::mutex> guard(fixLock);
+                fix = newFix;
+                fixCount++;
+            }
+            requestLoop();
         }
     }
 
-    // This custom version of delay() ensures that the gps object
-    // is being "fed".
-    void Gps::smartDelay(unsigned long ms)
+    String Gps::makePayload(const Fix& fix) const
     {
-        unsigned long start = millis();
-        do
+        String payload = "{ \"Lat\": " + String(fix.lat, 3U) + ", \"Lon\": " + String(fix.lng, 3U) + ", \"Alt\": " + String(fix.alt, 1U);
+
+        if (fix.hasDateTime)
         {
-            while (softwareSerial->available())
+            char sz[64] = {};
+            sprintf(sz, "%02d-%02d-%02d %02d:%02d:%02d", fix.year, fix.month, fix.day, fix.hour, fix.minute, fix.second);
+            payload += ", \"DateTimeUtc\": \"" + String(sz) + "\"";
+        }
+        payload += "}";
+        return payload;
+    }
+
+    void Gps::loop()
+    {
+        if (!noDataReported && millis() > 5000 && bytesReceived < 10)
+        {
+            Serial.println(F("No GPS data received: check wiring"));
+            noDataReported = true;
+        }
+
+        if (millis() - lastPublishMillis < publishIntervalMs)
+        {
+            return;
+        }
+
+        Fix current;
+        {
+            std::lock_guard<std::mutex> guard(fixLock);
+            if (fixCount == publishedFixCount)
             {
-                gps.encode(softwareSerial->read());
+                return; // no new fix
             }
-        } while (millis() - start < ms);
+            current           = fix;
+            publishedFixCount = fixCount;
+        }
+        lastPublishMillis = millis();
+        mqttClient->publishState(topicPosition, makePayload(current));
     }
-
 } // namespace IotZoo
 
 #endif
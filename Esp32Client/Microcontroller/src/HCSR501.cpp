@@ -10,6 +10,7 @@
 // --------------------------------------------------------------------------------------------------------------------
 #include "Defines.hpp"
 #ifdef USE_HC_SR501
+#include "DebugHelper.hpp"
 #include "HCSR501.hpp"
 #include "HRSR501Helper.hpp"
 
@@ -23,6 +24,7 @@ namespace IotZoo
     {
         Serial.println("Constructor HCSC501 pinMotionDetector: " + String(pinMotionDetector));
         this->pinMotionDetector = pinMotionDetector;
+        topicMotionDetectorTriggered = getBaseTopic() + "/motion_detector/" + String(deviceIndex) + "/triggered";
         pinMode(pinMotionDetector, INPUT_PULLDOWN);
         setup(HRSR501Helper::readInterrupt);
     }
@@ -37,7 +39,7 @@ namespace IotZoo
         bool isTriggered = isTriggered = motionDetectorCounterRising > oldMotionDetectorCounterRising;
         if (isTriggered)
         {
-            Serial.println("Motion detector " + String(index) + " triggered! " + String(lastMillisMotionDetectorRising));
+            logInfo("Motion detector " << index << " triggered! " << lastMillisMotionDetectorRising);
             oldMotionDetectorCounterRising = motionDetectorCounterRising;
         }
         return isTriggered;
@@ -79,8 +81,6 @@ namespace IotZoo
 
     void HCSC501::loop()
     {
-        String topicMotionDetectorTriggered = getBaseTopic() + "/motion_detector/" + String(getDeviceIndex()) + "/triggered";
-
         if (isTriggered())
         {
             mqttClient->publish(topicMotionDetectorTriggered, String(getCounterRising()));
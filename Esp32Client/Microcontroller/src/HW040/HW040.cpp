@@ -11,6 +11,7 @@
 #include "Defines.hpp"
 #ifdef USE_HW040
 
+#include "DebugHelper.hpp"
 #include "HW040/HW040.hpp"
 #include "HW040/HW040Helper.hpp"
 #include "MqttClient.hpp"
@@ -138,12 +139,10 @@ namespace IotZoo
             // don't do anything unless value changed.
             if (encoderChanged())
             {
-                Serial.print("Value encoder " + String(deviceIndex) + ": ");
                 long rotaryEncoderValue = readEncoder();
+                logDebug("Value encoder " << deviceIndex << ": " << rotaryEncoderValue);
 
-                Serial.println(rotaryEncoderValue);
-
-                mqttClient->publish(topicEncoderValue, String(rotaryEncoderValue));
+                mqttClient->publishState(topicEncoderValue, String(rotaryEncoderValue));
             }
         }
         catch (const std::exception& e)
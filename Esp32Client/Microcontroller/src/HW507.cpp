@@ -13,6 +13,7 @@
 #include "Defines.hpp"
 #ifdef USE_HW507
 
+#include "DebugHelper.hpp"
 #include "HW507.hpp"
 #include <math.h>
 
@@ -31,6 +32,7 @@ namespace IotZoo
                      ", intervalMs: " + String(intervalMs));
         pinMode(pinData, INPUT_PULLUP);
         dht = new DHT(pinData, deviceType);
+        topicHumidity = getBaseTopic() + "/dht/" + getHumiditySensorType() + "/humidity";
     }
 
     void HW507::addMqttTopicsToRegister(std::vector<Topic>* const topics) const
@@ -47,8 +49,6 @@ namespace IotZoo
 
     void HW507::loop()
     {
-        String topic = getBaseTopic() + "/dht/" + this->getHumiditySensorType() + "/humidity";
-
         if (millis() - lastMillis > intervalMs)
         {
             float humidity = dht->readHumidity();
@@ -58,9 +58,9 @@ namespace IotZoo
             }
             else
             {
-                Serial.println("humidity: " + String(humidity));
+                logDebug("humidity: " << humidity);
 
-                mqttClient->publish(topic, String(humidity, 1));
+                mqttClient->publishState(topicHumidity, String(humidity, 1));
             }
             lastMillis = millis();
         }
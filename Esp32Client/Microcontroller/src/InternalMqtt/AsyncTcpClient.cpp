@@ -0,0 +1,188 @@
+#include "Defines.hpp"
+
+#ifdef USE_INTERNAL_MQTT
+
+#include "./InternalMqtt/AsyncTcpClient.h"
+#include "DebugHelper.hpp"
+#include <algorithm>
+#include <lwip/pbuf.h>
+
+AsyncTcpClient::AsyncTcpClient(AsyncClient* client) : state(std::make_shared<State>())
+{
+    state->client = client;
+    client->setNoDelay(true);
+
+    // The callbacks share the state, the holder is deleted with the AsyncClient (onDisconnect).
+    StatePtr* holder = new StatePtr(state);
+    client->onPacket(onPacket, holder);
+    client->onAck(onAck, holder);
+    client->onDisconnect(onDisconnect, holder);
+}
+
+AsyncTcpClient::~AsyncTcpClient()
+{
+    stop();
+}
+
+size_t AsyncTcpClient::write(const uint8_t* buf, size_t size)
+{
+    std::lock_guard<std::recursive_mutex> guard(state->lock);
+    if (state->client == nullptr or state->overflow)
+    {
+        return 0;
+    }
+    const char* data = reinterpret_cast<const char*>(buf);
+    size_t      sent = state->txPending.empty() ? send(*state, data, size) : 0;
+    if (sent < size)
+    {
+        if (state->txPending.size() + size - sent > MaxTxPending)
+        {
+            debug("AsyncTcpClient: peer does not read, closing");
+            state->overflow = true;
+            return sent;
+        }
+        state->txPending.append(data + sent, size - sent);
+    }
+    return size;
+}
+
+int AsyncTcpClient::available()
+{
+    std::lock_guard<std::recursive_mutex> guard(state->lock);
+    return state->rxSize;
+}
+
+int AsyncTcpClient::read()
+{
+    uint8_t byte;
+    return read(&byte, 1) == 1 ? byte : -1;
+}
+
+int AsyncTcpClient::read(uint8_t* buf, size_t size)
+{
+    std::lock_guard<std::recursive_mutex> guard(state->lock);
+    size_t                                copied = 0;
+    while (copied < size and not state->rxPackets.empty())
+    {
+        pbuf*  packet = state->rxPackets.front();
+        size_t len    = std::min<size_t>(packet->len - state->rxOffset, size - copied);
+        memcpy(buf + copied, static_cast<const char*>(packet->payload) + state->rxOffset, len);
+        copied += len;
+        state->rxOffset += len;
+        state->rxSize -= len;
+        if (state->rxOffset == packet->len)
+        {
+            state->rxPackets.pop_front();
+            state->rxOffset = 0;
+            state->release(packet); // reopens the tcp window
+        }
+    }
+    return copied;
+}
+
+int AsyncTcpClient::peek()
+{
+    std::lock_guard<std::recursive_mutex> guard(state->lock);
+    if (state->rxPackets.empty())
+    {
+        return -1;
+    }
+    return static_cast<const uint8_t*>(state->rxPackets.front()->payload)[state->rxOffset];
+}
+
+void AsyncTcpClient::stop()
+{
+    std::lock_guard<std::recursive_mutex> guard(state->lock);
+    state->clearReceived();
+    state->txPending.clear();
+    if (state->client)
+    {
+        // onDisconnect is called from close() in this task and deletes the AsyncClient.
+        state->client->close(true);
+    }
+}
+
+uint8_t AsyncTcpClient::connected()
+{
+    std::lock_guard<std::recursive_mutex> guard(state->lock);
+    if (state->overflow)
+    {
+        return false;
+    }
+    return state->rxSize or (state->client and state->client->connected());
+}
+
+// AsyncTCP task
+void AsyncTcpClient::onPacket(void* arg, AsyncClient*, pbuf* packet)
+{
+    StatePtr                              state = *static_cast<StatePtr*>(arg);
+    std::lock_guard<std::recursive_mutex> guard(state->lock);
+    state->rxPackets.push_back(packet);
+    state->rxSize += packet->len;
+}
+
+// AsyncTCP task
+void AsyncTcpClient::onAck(void* arg, AsyncClient*, size_t, uint32_t)
+{
+    StatePtr                              state = *static_cast<StatePtr*>(arg);
+    std::lock_guard<std::recursive_mutex> guard(state->lock);
+    if (state->client and not state->txPending.empty())
+    {
+        size_t sent = send(*state, state->txPending.data(), state->txPending.size());
+        state->txPending.erase(0, sent);
+    }
+}
+
+// AsyncTCP task, or the task calling stop()
+void AsyncTcpClient::onDisconnect(void* arg, AsyncClient* client)
+{
+    StatePtr* holder = static_cast<StatePtr*>(arg);
+    StatePtr  state  = *holder;
+    {
+        std::lock_guard<std::recursive_mutex> guard(state->lock);
+        if (state->client != client)
+        {
+            return; // already disconnected
+        }
+        state->client = nullptr;
+        state->txPending.clear(); // received packets stay readable, they are freed when read
+    }
+    delete client;
+    delete holder;
+}
+
+void AsyncTcpClient::State::release(pbuf* packet)
+{
+    if (client)
+    {
+        client->ackPacket(packet);
+    }
+    else
+    {
+        pbuf_free(packet);
+    }
+}
+
+void AsyncTcpClient::State::clearReceived()
+{
+    for (auto packet : rxPackets)
+    {
+        release(packet);
+    }
+    rxPackets.clear();
+    rxOffset = 0;
+    rxSize   = 0;
+}
+
+size_t AsyncTcpClient::send(State& state, const char* data, size_t length)
+{
+    size_t sent = std::min(length, state.client->space());
+    if (sent)
+    {
+        sent = state.client->add(data, sent);
+        state.client->send();
+    }
+    return sent;
+}
+
+#endif // USE_INTERNAL_MQTT
@@ -3,15 +3,33 @@
 
 #ifdef USE_INTERNAL_MQTT
 
+#include "./InternalMqtt/AsyncTcpClient.h"
 #include "DebugHelper.hpp"
 #include <sstream>
 
-InternalMqttBroker::InternalMqttBroker(uint16_t port)
+static void encodePublish(MqttMessage& msg, const InternalTopic& topic, const char* payload, size_t length)
+{
+    msg.create(MqttMessage::Publish, 2 + topic.str().length() + length);
+    msg.add(topic);
+    msg.add(payload, length, false);
+    msg.complete();
+}
+
+InternalMqttBroker::InternalMqttBroker(uint16_t port) : port(port)
 {
 }
 
 InternalMqttBroker::~InternalMqttBroker()
 {
+    if (server)
+    {
+        server->end();
+        delete server;
+    }
+    for (auto client : accepted)
+    {
+        delete client;
+    }
     while (clients.size())
     {
         auto client         = clients[0];
@@ -35,8 +53,16 @@ InternalMqttClient::InternalMqttClient(InternalMqttBroker* internalMqttBroker, c
     }
 }
 
+// Connection accepted by the broker, added by InternalMqttBroker::onClient.
+InternalMqttClient::InternalMqttClient(InternalMqttBroker* local_broker, TcpClient* client) : localBroker(local_broker), tcpClient(client)
+{
+    keep_alive = 30;
+    alive      = millis() + 5000; // expires if no Connect within 5s
+}
+
 InternalMqttClient::~InternalMqttClient()
 {
+    resetFlag(CltFlagToDelete); // close() removes it from the broker now
     close();
     delete tcpClient;
     debug("*** MqttClient delete()");
@@ -46,6 +72,7 @@ void InternalMqttClient::close(bool bSendDisconnect)
 {
     debug("close " << id().c_str());
     resetFlag(CltFlagConnected);
+    rxBuffer.clear();
     if (nullptr != tcpClient) // connected to a remote broker
     {
         if (bSendDisconnect and tcpClient->connected())
@@ -57,7 +84,9 @@ void InternalMqttClient::close(bool bSendDisconnect)
         tcpClient->stop();
     }
 
-    if (localBroker)
+    // A connection accepted by the broker stays in its clients until InternalMqttBroker::loop() sees it disconnected
+    // and deletes it. Removing it here would leak it and skip the next client of the loop.
+    if (localBroker and not(cltFlags & CltFlagToDelete))
     {
         localBroker->removeClient(this);
         localBroker = nullptr;
@@ -79,7 +108,7 @@ void InternalMqttClient::connect(string broker, uint16_t port, uint16_t ka)
     close();
 
     delete tcpClient;
-    tcpClient = new TcpClient;
+    tcpClient = new WiFiClient;
 
     if (tcpClient->connect(broker.c_str(), port))
     {
@@ -96,6 +125,10 @@ void InternalMqttBroker::addClient(InternalMqttClient* client)
 {
     debug("MqttBroker::addClient");
     clients.push_back(client);
+    for (const auto& topic : client->subscriptions)
+    {
+        subscriptions.insert(topic.str(), client);
+    }
 }
 
 void InternalMqttBroker::connect(const string& host, uint16_t port)
@@ -124,6 +157,7 @@ void InternalMqttBroker::removeClient(InternalMqttClient* remove)
             //        -> we are using (memory) one IndexedString plus its string for nothing.
             debug("Remove " << clients.size());
             clients.erase(it);
+            subscriptions.removeSubscriber(remove);
             debug("Client removed " << clients.size());
             return;
         }
@@ -131,6 +165,25 @@ void InternalMqttBroker::removeClient(InternalMqttClient* remove)
     debug("Error cannot remove client");
 }
 
+void InternalMqttBroker::begin()
+{
+    if (server == nullptr)
+    {
+        server = new TcpServer(port);
+        server->setNoDelay(true);
+        server->onClient(onAccept, this);
+        server->begin();
+        debug("Internal broker listening on port " << port);
+    }
+}
+
+void InternalMqttBroker::onAccept(void* broker_ptr, AsyncClient* client)
+{
+    InternalMqttBroker*         broker = static_cast<InternalMqttBroker*>(broker_ptr);
+    std::lock_guard<std::mutex> guard(broker->acceptedLock);
+    broker->accepted.push_back(new AsyncTcpClient(client));
+}
+
 void InternalMqttBroker::onClient(void* broker_ptr, TcpClient* client)
 {
     debug("MqttBroker::onClient");
@@ -151,27 +204,46 @@ void InternalMqttBroker::loop()
         remoteBroker->loop();
     }
 
-    for (size_t i = 0; i < clients.size(); i++)
+    if (server)
+    {
+        std::vector<TcpClient*> adopt;
+        {
+            std::lock_guard<std::mutex> guard(acceptedLock);
+            adopt.swap(accepted);
+        }
+        for (auto client : adopt)
+        {
+            onClient(this, client);
+        }
+    }
+
+    size_t i = 0;
+    while (i < clients.size())
     {
         InternalMqttClient* client = clients[i];
         if (client->connected())
         {
             client->loop();
+            if (i < clients.size() and clients[i] == client)
+            {
+                i++;
+            }
         }
         else
         {
             debug("Client " << client->id().c_str() << " Disconnected, local_broker=" << (dbg_ptr)client->localBroker);
             // Note: deleting a client not added by the broker itself will probably crash later.
-            delete client;
-            break;
+            delete client; // removes it from clients, so i is the next one
         }
     }
 }
 
-InternalMqttError InternalMqttBroker::subscribe(const InternalTopic& topic, uint8_t qos)
+InternalMqttError InternalMqttBroker::subscribe(InternalMqttClient* client, const InternalTopic& topic, uint8_t qos)
 {
     debug("InternalMqttBroker::subscribe");
 
+    subscriptions.insert(topic.str(), client);
+
     if (remoteBroker && remoteBroker->connected())
     {
         return remoteBroker->subscribe(topic, qos);
@@ -179,47 +251,74 @@ InternalMqttError InternalMqttBroker::subscribe(const InternalTopic& topic, uint
     return MqttNowhereToSend;
 }
 
-InternalMqttError InternalMqttBroker::publish(const InternalMqttClient* source, const InternalTopic& topic, MqttMessage& msg) const
+void InternalMqttBroker::unsubscribe(InternalMqttClient* client, const InternalTopic& topic)
+{
+    debug("InternalMqttBroker::unsubscribe");
+    subscriptions.remove(topic.str(), client);
+}
+
+InternalMqttError InternalMqttBroker::publish(const InternalMqttClient* source, const InternalTopic& topic, MqttMessage& msg)
 {
     InternalMqttError retval = MqttOk;
 
     debug("MqttBroker::publish");
-    int i = 0;
-    for (auto client : clients)
+    debug("broker:" << (remoteBroker && remoteBroker->connected() ? "linked" : "alone") << "  srce=" << (source->isLocal() ? "loc" : "rem"));
+
+    if (remoteBroker && remoteBroker->connected() && source != remoteBroker)
     {
-        i++;
+        // This broker is connected to another broker, simply forward the msg (external clients -> this broker -> ext_broker)
+        return remoteBroker->publishIfSubscribed(topic, msg);
+    }
+
+    // ext_broker -> internal clients or this broker is alone.
+    // Local copy: a callback may publish again while we are iterating.
+    TopicTrie<InternalMqttClient*>::Subscribers matchingClients;
+    subscriptions.match(topic.str(), matchingClients);
+    for (auto client : matchingClients)
+    {
+        debug("clt local=" << client->isLocal() << ", con=" << client->connected());
+        InternalMqttError ret = client->deliver(topic, msg);
+        if (ret != MqttOk)
+        {
+            retval = ret;
+        }
+    }
+    return retval;
+}
 
-        debug("broker:" << (remoteBroker && remoteBroker->connected() ? "linked" : "alone")
-                << "  srce=" << (source->isLocal() ? "loc" : "rem") << " clt#" << i << ", local=" << client->isLocal()
-                << ", con=" << client->connected() << endl);
+InternalMqttError InternalMqttBroker::publish(const InternalMqttClient* source, const InternalTopic& topic, const char* payload, size_t length)
+{
+    InternalMqttError retval = MqttOk;
+    MqttMessage       msg;
+    bool              encoded = false;
 
-        bool doit = false;
-        if (remoteBroker && remoteBroker->connected()) // this (MqttBroker) is connected (to a external broker)
+    debug("MqttBroker::publish local");
+    if (remoteBroker && remoteBroker->connected() && source != remoteBroker)
+    {
+        encodePublish(msg, topic, payload, length);
+        return remoteBroker->publishIfSubscribed(topic, msg);
+    }
+
+    // Local copy: a callback may publish again while we are iterating.
+    TopicTrie<InternalMqttClient*>::Subscribers matchingClients;
+    subscriptions.match(topic.str(), matchingClients);
+    for (auto client : matchingClients)
+    {
+        if (client->isLocal())
         {
-            // ext_broker -> clients or clients -> ext_broker
-            if (source == remoteBroker) // external broker -> internal clients
-            {
-                doit = true;
-            }
-            else // external clients -> this broker
-            {
-                // As this broker is connected to another broker, simply forward the msg
-                InternalMqttError ret = remoteBroker->publishIfSubscribed(topic, msg);
-                if (ret != MqttOk)
-                {
-                    retval = ret;
-                }
-            }
+            client->deliver(topic, payload, length);
+            continue;
         }
-        else // Disconnected
+        if (not encoded)
         {
-            doit = true;
+            encodePublish(msg, topic, payload, length);
+            encoded = true;
         }
-        if (doit)
+        InternalMqttError ret = client->deliver(topic, msg);
+        if (ret != MqttOk)
         {
-            retval = client->publishIfSubscribed(topic, msg);
+            retval = ret;
         }
-
     }
     return retval;
 }
@@ -255,7 +354,12 @@ void InternalMqttClient::loop()
 {
     if (keep_alive && (millis() >= alive))
     {
-        if (nullptr != localBroker)
+        if (nullptr != localBroker and nullptr != tcpClient)
+        {
+            debug("timeout client");
+            tcpClient->stop(); // not connected any more, the broker deletes it
+        }
+        else if (nullptr != localBroker)
         {
             debug("timeout client");
             close();
@@ -272,12 +376,35 @@ void InternalMqttClient::loop()
 
     while (tcpClient && tcpClient->available() > 0)
     {
-        message.incoming(tcpClient->read());
-        if (message.type())
+        size_t room;
+        char*  dest = rxBuffer.writable(room);
+        int    len  = tcpClient->read(reinterpret_cast<uint8_t*>(dest), room);
+        if (len <= 0)
+        {
+            break;
+        }
+        rxBuffer.commit(len);
+        processReceived();
+    }
+}
+
+void InternalMqttClient::processReceived()
+{
+    while (not rxBuffer.empty())
+    {
+        size_t      len;
+        const char* data = rxBuffer.readable(len);
+        size_t      used = message.incoming(data, len);
+        rxBuffer.consume(used);
+        if (message.isComplete())
         {
-            processMessage(&message);
+            processMessage(&message); // closes the connection on an unknown type
             message.reset();
         }
+        else if (used == 0)
+        {
+            break; // never spin on data the parser does not take
+        }
     }
 }
 
@@ -326,6 +453,11 @@ InternalMqttError InternalMqttClient::subscribe(InternalTopic topic, uint8_t qos
     debug("Subscribing to internal topic " + String(topic.c_str()));
     InternalMqttError ret = MqttOk;
 
+    if (not topic.valid())
+    {
+        return MqttTooManyTopics;
+    }
+
     subscriptions.insert(topic);
 
     if (localBroker == nullptr) // remote broker
@@ -336,7 +468,7 @@ InternalMqttError InternalMqttClient::subscribe(InternalTopic topic, uint8_t qos
     else
     {
         debug("Subscribing to local topic " + String(topic.c_str()));
-        return localBroker->subscribe(topic, qos);
+        return localBroker->subscribe(this, topic, qos);
     }
     return ret;
 }
@@ -352,6 +484,7 @@ InternalMqttError InternalMqttClient::unsubscribe(InternalTopic topic)
         {
             return sendTopic(topic, MqttMessage::Type::UnSubscribe, 0);
         }
+        localBroker->unsubscribe(this, topic);
     }
     return MqttOk;
 }
@@ -374,7 +507,7 @@ InternalMqttError InternalMqttClient::sendTopic(const InternalTopic& topic, Mqtt
 
 void InternalMqttClient::processMessage(MqttMessage* mesg)
 {
-#if USE_DEBUG_MESSAGES
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
     mesg->hexdump("Incoming");
 #endif
     auto        header = mesg->getVHeader();
@@ -498,6 +631,12 @@ void InternalMqttClient::processMessage(MqttMessage* mesg)
             if (mesg->type() == MqttMessage::Type::Subscribe)
             {
                 uint8_t qos = *payload++;
+                if (not topic.valid())
+                {
+                    debug("Too many topics, subscription refused");
+                    qoss.push_back(0x80);
+                    continue;
+                }
                 if (qos != 0)
                 {
                     debug("Unsupported QOS" << qos << endl);
@@ -506,12 +645,16 @@ void InternalMqttClient::processMessage(MqttMessage* mesg)
                 else
                     qoss.push_back(qos);
                 subscriptions.insert(topic);
+                if (localBroker)
+                    localBroker->subscriptions.insert(topic.str(), this);
             }
             else
             {
                 auto it = subscriptions.find(topic);
                 if (it != subscriptions.end())
                     subscriptions.erase(it);
+                if (localBroker)
+                    localBroker->unsubscribe(this, topic);
             }
         }
         debug("end loop");
@@ -532,7 +675,7 @@ void InternalMqttClient::processMessage(MqttMessage* mesg)
         break;
 
     case MqttMessage::Type::Publish:
-#if USE_DEBUG_MESSAGES
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
         Console << "publish " << mqtt_connected() << '/' << (long)tcpClient << endl;
 #endif
         if (mqtt_connected() or tcpClient == nullptr)
@@ -542,7 +685,13 @@ void InternalMqttClient::processMessage(MqttMessage* mesg)
             mesg->getString(payload, len);
             InternalTopic published(payload, len);
             payload += len;
-#if USE_DEBUG_MESSAGES
+            if (not published.valid())
+            {
+                debug("Too many topics, publish dropped");
+                bclose = false;
+                break;
+            }
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
             Console << "Received Publish (" << published.str().c_str() << ") size=" << (int)len << endl;
 #endif
             // << '(' << string(payload, len).c_str() << ')'  << " msglen=" << mesg->length() << endl;
@@ -554,14 +703,12 @@ void InternalMqttClient::processMessage(MqttMessage* mesg)
 
             if (localBroker == nullptr or tcpClient == nullptr) // internal MqttClient receives publish
             {
-#if USE_DEBUG_MESSAGES
-                if (DebugHelper::debugLevel >= 2)
-                {
-                    Console << (isSubscribedTo(published) ? "not" : "") << " subscribed.\n";
-                    Console << "has " << (callback ? "" : "no ") << " callback.\n";
-                }
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+                Console << (isSubscribedTo(published) ? "not" : "") << " subscribed.\n";
+                Console << "has " << (callback ? "" : "no ") << " callback.\n";
 #endif
-                if (callback and isSubscribedTo(published))
+                // A local broker only delivers to matching subscribers (see InternalMqttBroker::publish).
+                if (callback and (localBroker or isSubscribedTo(published)))
                 {
                     callback(this, published, payload, len); // TODO send the real payload
                 }
@@ -590,7 +737,7 @@ void InternalMqttClient::processMessage(MqttMessage* mesg)
     };
     if (bclose)
     {
-#if USE_DEBUG_MESSAGES
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
         debug("*************** Error msg 0x" << _HEX(mesg->type()));
         mesg->hexdump("------- ERROR -------");
         dump();
@@ -606,6 +753,8 @@ void InternalMqttClient::processMessage(MqttMessage* mesg)
 
 bool InternalTopic::matches(const InternalTopic& topic) const
 {
+    if (not valid() or not topic.valid())
+        return false;
     if (getIndex() == topic.getIndex())
         return true;
     const char* p1 = c_str();
@@ -684,19 +833,25 @@ bool InternalTopic::matches(const InternalTopic& topic) const
 // publish from local client
 InternalMqttError InternalMqttClient::publish(const InternalTopic& topic, const char* payload, size_t pay_length)
 {
+    if (payload == nullptr)
+    {
+        payload    = "";
+        pay_length = 0;
+    }
+    if (not topic.valid())
+    {
+        return MqttTooManyTopics;
+    }
     debug("Publishing to internal MQTT topic: " + String(topic.c_str()) + ", payload: " + String(payload));
 
-    MqttMessage msg(MqttMessage::Publish);
-    msg.add(topic);
-    msg.add(payload, pay_length, false);
-    msg.complete();
-
     if (localBroker)
     {
-        return localBroker->publish(this, topic, msg);
+        return localBroker->publish(this, topic, payload, pay_length);
     }
     else if (tcpClient)
     {
+        MqttMessage msg;
+        encodePublish(msg, topic, payload, pay_length);
         return msg.sendTo(this);
     }
     else
@@ -713,16 +868,33 @@ InternalMqttError InternalMqttClient::publishIfSubscribed(const InternalTopic& t
     debug("mqttclient publishIfSubscribed topic: " << topic.c_str() << ", subscriptions: " << subscriptions.size());
     if (isSubscribedTo(topic))
     {
-        if (tcpClient)
-        {
-            debug("Forwarding message for topic: " << topic.c_str() << " to external broker");
-            retval = msg.sendTo(this);
-        }
-        else
-        {
-            debug("Processing message for topic: " << topic.c_str());
-            processMessage(&msg);
-        }
+        retval = deliver(topic, msg);
+    }
+    return retval;
+}
+
+void InternalMqttClient::deliver(const InternalTopic& topic, const char* payload, size_t length)
+{
+    debug("Local delivery of topic: " << topic.c_str());
+    if (callback)
+    {
+        callback(this, topic, payload, length);
+    }
+}
+
+InternalMqttError InternalMqttClient::deliver(const InternalTopic& topic, MqttMessage& msg)
+{
+    InternalMqttError retval = MqttOk;
+
+    if (tcpClient)
+    {
+        debug("Forwarding message for topic: " << topic.c_str() << " to external broker");
+        retval = msg.sendTo(this);
+    }
+    else
+    {
+        debug("Processing message for topic: " << topic.c_str());
+        processMessage(&msg);
     }
     return retval;
 }
@@ -792,7 +964,7 @@ void MqttMessage::incoming(char in_byte)
         break;
     case Complete:
     default:
-#if USE_DEBUG_MESSAGES
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
         debug("Spurious " << _HEX(in_byte) << endl);
         hexdump("spurious");
 #endif
@@ -806,32 +978,85 @@ void MqttMessage::incoming(char in_byte)
     }
 }
 
+size_t MqttMessage::incoming(const char* p, size_t length)
+{
+    size_t used = 0;
+    while (used < length and state != Complete)
+    {
+        if (state == VariableHeader or state == PayLoad)
+        {
+            size_t chunk = std::min<size_t>(size, length - used);
+            buffer.append(p + used, chunk);
+            used += chunk;
+            size -= chunk;
+            if (size == 0)
+            {
+                state = Complete;
+            }
+        }
+        else
+        {
+            // fixed header and remaining length, at most a few bytes
+            incoming(p[used++]);
+        }
+    }
+    return used;
+}
+
 void MqttMessage::add(const char* p, size_t len, bool addLength)
 {
+    if (state == Error)
+    {
+        return; // overflowed, see add(char)
+    }
+    if (state != Create)
+    {
+        if (addLength)
+        {
+            incoming(len >> 8);
+            incoming(len & 0xFF);
+        }
+        while (len--)
+            incoming(*p++);
+        return;
+    }
+    if (buffer.length() + len + (addLength ? 2 : 0) > MaxBufferLength)
+    {
+        debug("Too long " << buffer.length() + len);
+        buffer.clear();
+        state = Error;
+        return;
+    }
     if (addLength)
     {
-        buffer.reserve(buffer.length() + 2);
-        incoming(len >> 8);
-        incoming(len & 0xFF);
+        buffer += static_cast<char>(len >> 8);
+        buffer += static_cast<char>(len & 0xFF);
     }
-    while (len--)
-        incoming(*p++);
+    buffer.append(p, len);
+    size += len + (addLength ? 2 : 0);
 }
 
 void MqttMessage::encodeLength()
 {
     debug("encodeLength");
-    if (state != Complete)
+    if (state == Create)
     {
-        int length = buffer.size() - 3; // 3 = 1 byte for header + 2 bytes for pre-reserved length field.
+        int length = buffer.size() - vheader; // vheader = 1 byte for header + 1 or 2 bytes for the pre-reserved length field.
         if (length <= 0x7F)
         {
-            buffer.erase(1, 1);
+            if (vheader == 3)
+            {
+                buffer.erase(1, 1);
+            }
             buffer[1] = length;
             vheader   = 2;
         }
         else
         {
+            if (vheader == 2)
+            {
+                buffer.insert(1, 1, '\0'); // expected length was too short
+            }
             buffer[1] = 0x80 | (length & 0x7F);
             buffer[2] = (length >> 7);
             vheader   = 3;
@@ -862,9 +1087,7 @@ InternalMqttError MqttMessage::sendTo(InternalMqttClient* client)
 void MqttMessage::hexdump(const char* prefix) const
 {
     (void)prefix;
-#if USE_DEBUG_MESSAGES
-    if (DebugHelper::debugLevel < 2)
-        return;
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
     static std::map<Type, string> tts = {{Connect, "Connect"},     {ConnAck, "Connack"},   {Publish, "Publish"},         {PubAck, "Puback"},
                                          {Subscribe, "Subscribe"}, {SubAck, "Suback"},     {UnSubscribe, "Unsubscribe"}, {UnSuback, "Unsuback"},
                                          {PingReq, "Pingreq"},     {PingResp, "Pingresp"}, {Disconnect, "Disconnect"}};
@@ -4,6 +4,10 @@
 
 #include "./InternalMqtt/StringIndexer.h"
 
-StringIndexer::Strings StringIndexer::strings;
+StringIndexer::Entries              StringIndexer::entries;
+StringIndexer::Lookup               StringIndexer::lookup;
+std::vector<StringIndexer::index_t> StringIndexer::freeIndexes;
+size_t                              StringIndexer::stringBytes = 0;
+StringIndexer::Stats                StringIndexer::statistics;
 
 #endif // USE_INTERNAL_MQTT
\ No newline at end of file
@@ -75,16 +75,111 @@ namespace IotZoo
 
     bool MqttClient::publish(const String& topic, const String& payload, bool retain)
     {
-        Serial.println("─┐");
-        debug(">>> Publishing topic:\r\n" + topic + "\r\n\r\npayload ↣ " + payload + "\r\n" +
-                     "\r\nMqttBrokerIp: " + this->mqttClient->getMqttServerIp());
-        if (!mqttClient->isConnected())
+        return publishText(topic, payload, retain, false);
+    }
+
+    bool MqttClient::publishState(const String& topic, const String& payload, bool retain)
+    {
+        return publishText(topic, payload, retain, true);
+    }
+
+    bool MqttClient::publishText(const String& topic, const String& payload, bool retain, bool state)
+    {
+#ifdef USE_DUAL_CORE
+        if (!isNetworkTask())
         {
-           return printSuccess(false);
-        }        
+            OutboundCommand command;
+            command.topic   = topic;
+            command.payload = payload;
+            command.retain  = retain;
+            command.state   = state;
+            return pushOutbound(std::move(command));
+        }
+#endif
+        return publishOrStore(topic, payload, retain, state);
+    }
+
+    bool MqttClient::publishOrStore(const String& topic, const String& payload, bool retain, bool state)
+    {
+        // Held while publishing, so a message of another task cannot overtake the waiting ones.
+        std::lock_guard<std::mutex> guard(pendingLock);
+        if (!pending.empty() || !isConnected())
+        {
+            store(topic, payload, retain, state);
+            return true;
+        }
+        logDebug("─┐");
+        logDebug(">>> Publishing topic:\r\n" + topic + "\r\n\r\npayload ↣ " + payload + "\r\n" +
+                     "\r\nMqttBrokerIp: " + this->mqttClient->getMqttServerIp());
         return printSuccess(mqttClient->publish(topic, payload, retain));
     }
 
+    void MqttClient::store(const String& topic, const String& payload, bool retain, bool state)
+    {
+        bool coalesced = false;
+        if (state)
+        {
+            for (auto& message : pending)
+            {
+                if (message.state && message.topic == topic)
+                {
+                    pendingBytes    = pendingBytes - message.payload.length() + payload.length();
+                    message.payload = payload;
+                    message.retain  = retain;
+                    pendingCoalesced++;
+                    coalesced = true;
+                    break;
+                }
+            }
+        }
+        if (!coalesced)
+        {
+            pending.push_back(PendingMessage{topic, payload, retain, state});
+            pendingBytes += payload.length();
+        }
+        // The oldest messages make room, a single message may be larger than MaxPendingBytes.
+        while (pending.size() > MaxPendingMessages || (pendingBytes > MaxPendingBytes && pending.size() > 1))
+        {
+            pendingBytes -= pending.front().payload.length();
+            pending.pop_front();
+            pendingDropped++;
+        }
+        pendingCount = pending.size();
+    }
+
+    void MqttClient::drainPending()
+    {
+        std::lock_guard<std::mutex> guard(pendingLock);
+        for (size_t count = 0; count < MaxDrainPerLoop && !pending.empty() && isConnected(); count++)
+        {
+            PendingMessage& message = pending.front();
+            logDebug(">>> Publishing stored topic:\r\n" + message.topic + "\r\n\r\npayload ↣ " + message.payload);
+            if (!printSuccess(mqttClient->publish(message.topic, message.payload, message.retain)))
+            {
+                pendingDropped++;
+            }
+            pendingBytes -= message.payload.length();
+            pending.pop_front();
+        }
+        pendingCount = pending.size();
+    }
+
+    bool MqttClient::publish(const String& topic, const uint8_t* payload, unsigned int payloadLength, boolean retained)
+    {
+#ifdef USE_DUAL_CORE
+        if (!isNetworkTask())
+        {
+            OutboundCommand command;
+            command.topic = topic;
+            command.payload.concat(reinterpret_cast<const char*>(payload), payloadLength);
+            command.retain = retained;
+            command.binary = true;
+            return pushOutbound(std::move(command));
+        }
+#endif
+        return printSuccess(mqttClient->publish(topic.c_str(), payload, payloadLength, retained));
+    }
+
     /// @brief
     /// @param topic
     /// @param messageReceivedCallback
@@ -92,18 +187,56 @@ namespace IotZoo
     /// @return
     bool MqttClient::subscribe(const String& topic, MessageReceivedCallback messageReceivedCallback, uint8_t qos)
     {
+#ifdef USE_DUAL_CORE
+        return subscribe(
+            topic, [messageReceivedCallback](const String& /* topic */, const String& payload) { messageReceivedCallback(payload); }, qos);
+#else
         debug("Subscribing to topic: " + topic + ", qos: " + String(qos));
         return printSuccess(mqttClient->subscribe(topic, messageReceivedCallback, qos));
+#endif
     }
 
     bool MqttClient::subscribe(const String& topic, MessageReceivedCallbackWithTopic messageReceivedCallback, uint8_t qos)
     {
+#ifdef USE_DUAL_CORE
+        // The client calls the callback on the network task, so it only queues the message for the device task.
+        auto                             callback = std::make_shared<MessageReceivedCallbackWithTopic>(messageReceivedCallback);
+        MessageReceivedCallbackWithTopic queueMessage = [this, callback](const String& topic, const String& payload)
+        {
+            InboundMessage message;
+            message.callback = callback;
+            message.topic    = topic;
+            message.payload  = payload;
+            inbound.push(std::move(message));
+        };
+        if (!isNetworkTask())
+        {
+            OutboundCommand command;
+            command.kind     = OutboundCommand::Kind::Subscribe;
+            command.topic    = topic;
+            command.qos      = qos;
+            command.callback = queueMessage;
+            return pushOutbound(std::move(command));
+        }
+        debug("Subscribing to topic: " + topic + ", qos: " + String(qos));
+        return printSuccess(mqttClient->subscribe(topic, queueMessage, qos));
+#else
         debug("Subscribing to topic: " + topic + ", qos: " + String(qos));
         return printSuccess(mqttClient->subscribe(topic, messageReceivedCallback, qos));
+#endif
     }
 
     bool MqttClient::unsubscribe(const String& topic)
     {
+#ifdef USE_DUAL_CORE
+        if (!isNetworkTask())
+        {
+            OutboundCommand command;
+            command.kind  = OutboundCommand::Kind::Unsubscribe;
+            command.topic = topic;
+            return pushOutbound(std::move(command));
+        }
+#endif
         return mqttClient->unsubscribe(topic);
     }
 
@@ -126,21 +259,75 @@ namespace IotZoo
 
     /// Main loop
     void MqttClient::loop()
-    {        
+    {
+#ifdef USE_DUAL_CORE
+        OutboundCommand command;
+        for (size_t count = 0; count < QueueCapacity && outbound.pop(command); count++)
+        {
+            switch (command.kind)
+            {
+            case OutboundCommand::Kind::Publish:
+                if (command.binary)
+                {
+                    publishNow(command.topic, reinterpret_cast<const uint8_t*>(command.payload.c_str()), command.payload.length(), command.retain);
+                }
+                else
+                {
+                    publishOrStore(command.topic, command.payload, command.retain, command.state);
+                }
+                break;
+            case OutboundCommand::Kind::Subscribe:
+                debug("Subscribing to topic: " + command.topic + ", qos: " + String(command.qos));
+                printSuccess(mqttClient->subscribe(command.topic, command.callback, command.qos));
+                break;
+            case OutboundCommand::Kind::Unsubscribe:
+                mqttClient->unsubscribe(command.topic);
+                break;
+            }
+        }
+#endif
         mqttClient->loop();
+        drainPending(); // after onConnectionEstablished() has subscribed again
+    }
+
+#ifdef USE_DUAL_CORE
+    bool MqttClient::pushOutbound(OutboundCommand&& command)
+    {
+        std::lock_guard<std::mutex> guard(outboundLock);
+        return outbound.push(std::move(command));
+    }
+
+    bool MqttClient::publishNow(const String& topic, const uint8_t* payload, unsigned int payloadLength, bool retained)
+    {
+        logDebug(">>> Publishing topic:\r\n" << topic << "\r\n\r\npayload length: " << payloadLength);
+        if (!mqttClient->isConnected())
+        {
+            return printSuccess(false);
+        }
+        return printSuccess(mqttClient->publish(topic.c_str(), payload, payloadLength, retained));
+    }
+
+    void MqttClient::dispatchReceivedMessages()
+    {
+        InboundMessage message;
+        for (size_t count = 0; count < QueueCapacity && inbound.pop(message); count++)
+        {
+            (*message.callback)(message.topic, message.payload);
+        }
     }
+#endif // USE_DUAL_CORE
 
     bool MqttClient::printSuccess(bool ok)
     {        
         if (ok)
         {
-            debug(" -> OK " + String(millis()));
+            logDebug(" -> OK " << millis());
         }
         else
         {
-            debug(" -> NOK " + String(millis()));
+            logError(" -> NOK " << millis());
         }
-        debug("─┘");
+        logDebug("─┘");
         return ok;
     }
 } // namespace IotZoo
@@ -0,0 +1,197 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Effects rendered on the microcontroller for WS2818 and PixelMatrix: fade, blink, chase, breathe, gradient and scroll.
+// --------------------------------------------------------------------------------------------------------------------
+#include "Defines.hpp"
+#ifdef USE_WS2818
+#include "PixelEffects.hpp"
+
+#include <algorithm>
+
+namespace IotZoo
+{
+    // Fractions are 16 bit fixed point: 65536 is 1.
+    static const uint32_t One = 65536;
+
+    bool PixelEffects::start(const PixelEffect& effect)
+    {
+        auto sameRange = std::find_if(effects.begin(), effects.end(), [&effect](const PixelEffect& running)
+                                      { return running.StartIndex == effect.StartIndex && running.Length == effect.Length; });
+        if (sameRange == effects.end() && effects.size() >= MaxEffects)
+        {
+            return false;
+        }
+
+        unsigned long now = millis();
+        if (effects.empty())
+        {
+            nextFrameMillis = now;
+        }
+        PixelEffect& started = sameRange == effects.end() ? effects.emplace_back() : *sameRange;
+        started              = effect;
+        started.StartMillis  = now;
+        if (started.PeriodMs == 0)
+        {
+            started.PeriodMs = 1;
+        }
+        if (started.Length == 0)
+        {
+            started.Length = 1;
+        }
+        return true;
+    }
+
+    void PixelEffects::stop()
+    {
+        effects.clear();
+    }
+
+    unsigned long PixelEffects::getMillisUntilNextFrame(unsigned long now) const
+    {
+        long remaining = (long)(nextFrameMillis - now);
+        return remaining > 0 ? remaining : 0;
+    }
+
+    uint32_t PixelEffects::mix(uint32_t a, uint32_t b, uint32_t fraction)
+    {
+        uint32_t result = 0;
+        for (uint8_t shift = 0; shift < 24; shift += 8)
+        {
+            uint32_t channelA = (a >> shift) & 0xFF;
+            uint32_t channelB = (b >> shift) & 0xFF;
+            result |= ((channelA * (One - fraction) + channelB * fraction) >> 16) << shift;
+        }
+        return result;
+    }
+
+    uint32_t PixelEffects::triangle(uint16_t phase)
+    {
+        return phase < One / 2 ? phase * 2 : (One - phase) * 2;
+    }
+
+    uint32_t PixelEffects::colorAt(const PixelEffect& effect, uint16_t offset, uint32_t phase)
+    {
+        switch (effect.Type)
+        {
+            case PixelEffectType::Fade:
+                return mix(effect.Color, effect.Color2, phase);
+            case PixelEffectType::Blink:
+                return phase < One / 2 ? effect.Color : effect.Color2;
+            case PixelEffectType::Chase:
+            {
+                uint16_t position = (phase * effect.Length) >> 16;
+                uint16_t distance = (offset + effect.Length - position) % effect.Length;
+                return distance < effect.Width ? effect.Color : effect.Color2;
+            }
+            case PixelEffectType::Breathe:
+            {
+                uint32_t level = triangle(phase);
+                return mix(effect.Color2, effect.Color, (level * (level >> 1)) >> 15); // squared, looks more even to the eye
+            }
+            case PixelEffectType::Gradient:
+                return effect.Length < 2 ? effect.Color : mix(effect.Color, effect.Color2, offset * One / (effect.Length - 1));
+            case PixelEffectType::Scroll:
+                return mix(effect.Color, effect.Color2, triangle((offset * One / effect.Length + phase) & 0xFFFF));
+        }
+        return 0;
+    }
+
+    bool PixelEffects::setPixel(uint32_t* colors, uint16_t index, uint32_t color, uint16_t& first, uint16_t& last, bool changed)
+    {
+        if (colors[index] == color)
+        {
+            return changed;
+        }
+        colors[index] = color;
+        first = changed ? std::min(first, index) : index;
+        last  = changed ? std::max(last, index) : index;
+        return true;
+    }
+
+    bool PixelEffects::render(unsigned long now, unsigned long frameIntervalMs, uint32_t* colors, uint16_t numberOfPixels, uint16_t& first,
+                              uint16_t& last)
+    {
+        if (effects.empty() || (long)(now - nextFrameMillis) < 0)
+        {
+            return false;
+        }
+        // fixed rate: the frames do not drift with the loop, but a late frame is not caught up
+        nextFrameMillis += frameIntervalMs;
+        if ((long)(now - nextFrameMillis) >= 0)
+        {
+            nextFrameMillis = now + frameIntervalMs;
+        }
+
+        // Position of each effect in its period, once per frame.
+        uint32_t phases[MaxEffects];
+        uint16_t lowest  = numberOfPixels;
+        uint16_t highest = 0;
+        for (size_t i = 0; i < effects.size(); i++)
+        {
+            const PixelEffect& effect  = effects[i];
+            unsigned long      elapsed = now - effect.StartMillis;
+            if (effect.Type == PixelEffectType::Fade)
+            {
+                phases[i] = elapsed >= effect.PeriodMs ? One : elapsed * One / effect.PeriodMs;
+            }
+            else
+            {
+                phases[i] = ((elapsed % effect.PeriodMs) << 16) / effect.PeriodMs;
+            }
+            lowest  = std::min<uint16_t>(lowest, effect.StartIndex);
+            highest = std::max<uint16_t>(highest, std::min<uint32_t>(effect.StartIndex + effect.Length, numberOfPixels));
+        }
+
+        bool changed = false;
+        for (uint16_t index = lowest; index < highest; index++)
+        {
+            uint32_t color   = 0;
+            bool     covered = false;
+            for (size_t i = 0; i < effects.size(); i++)
+            {
+                const PixelEffect& effect = effects[i];
+                if (index < effect.StartIndex || index >= effect.StartIndex + effect.Length)
+                {
+                    continue;
+                }
+                uint32_t effectColor = colorAt(effect, index - effect.StartIndex, phases[i]);
+                color                = effect.Opacity == 255 ? effectColor : mix(color, effectColor, (uint32_t)effect.Opacity << 8);
+                covered              = true;
+            }
+            if (covered)
+            {
+                changed = setPixel(colors, index, color, first, last, changed);
+            }
+        }
+
+        // Finished effects: a fade or gradient keeps its last frame, an effect with a duration turns its pixels off.
+        for (auto effect = effects.begin(); effect != effects.end();)
+        {
+            unsigned long elapsed = now - effect->StartMillis;
+            if (effect->DurationMs != 0 && elapsed >= effect->DurationMs)
+            {
+                for (uint16_t index = effect->StartIndex; index < effect->StartIndex + effect->Length && index < numberOfPixels; index++)
+                {
+                    changed = setPixel(colors, index, 0, first, last, changed);
+                }
+                effect = effects.erase(effect);
+            }
+            else if (effect->Type == PixelEffectType::Gradient || (effect->Type == PixelEffectType::Fade && elapsed >= effect->PeriodMs))
+            {
+                effect = effects.erase(effect);
+            }
+            else
+            {
+                effect++;
+            }
+        }
+        return changed;
+    }
+} // namespace IotZoo
+#endif // USE_WS2818
@@ -12,6 +12,7 @@
 #include "Defines.hpp"
 #ifdef USE_RD_03D
 
+#include "DebugHelper.hpp"
 #include "RD03D.hpp"
 
 #include <ArduinoJson.h>
@@ -109,13 +110,13 @@ namespace IotZoo
 
                 if (target1.distanceMillimeters < maxDistanceMillimeters && target1.distanceMillimeters > 0)
                 {
-                    Serial.println("Target 1 Distance: " + String(target1.distanceMillimeters));
+                    logDebug("Target 1 Distance: " << target1.distanceMillimeters);
                     target1IsMoving    = true;
                     millisTarget1Moved = millis();
 
                     countOfDetectedPeople++;
 
-                    mqttClient->publish(topicDistanceTarget1, String(target1.distanceMillimeters));
+                    mqttClient->publishState(topicDistanceTarget1, String(target1.distanceMillimeters));
                     mqttClient->publish(topicMovementChangeTarget1, serializeTarget(target1));
                 }
                 else
@@ -128,10 +129,10 @@ namespace IotZoo
 
                 if (target2.distanceMillimeters < maxDistanceMillimeters && target2.distanceMillimeters > 0)
                 {
-                    Serial.println("Target 2 Distance: " + String(target2.distanceMillimeters));
+                    logDebug("Target 2 Distance: " << target2.distanceMillimeters);
                     countOfDetectedPeople++;
 
-                    mqttClient->publish(topicDistanceTarget2, String(target2.distanceMillimeters));
+                    mqttClient->publishState(topicDistanceTarget2, String(target2.distanceMillimeters));
                     mqttClient->publish(topicMovementChangeTarget2, serializeTarget(target2));
 
                     millisTarget2Moved = millis();
@@ -144,10 +145,10 @@ namespace IotZoo
 
                 if (target3.distanceMillimeters < maxDistanceMillimeters && target3.distanceMillimeters > 0)
                 {
-                    Serial.println("Target 3 Distance: " + String(target3.distanceMillimeters));
+                    logDebug("Target 3 Distance: " << target3.distanceMillimeters);
                     countOfDetectedPeople++;
 
-                    mqttClient->publish(topicDistanceTarget3, String(target3.distanceMillimeters));
+                    mqttClient->publishState(topicDistanceTarget3, String(target3.distanceMillimeters));
                     mqttClient->publish(topicMovementChangeTarget3, serializeTarget(target2));
 
                     millisTarget3Moved = millis();
@@ -191,8 +192,8 @@ namespace IotZoo
             Serial.println("Moving status changed -> target1IsMoving: " + String(target1IsMoving) + ", target2IsMoving: " + String(target2IsMoving) +
                            ", target3IsMoving: " + String(target3IsMoving) + ", Count of People in Range: " + String(countOfPeopleInRange));
 
-            mqttClient->publish(topicMovementDetected, String(isMovingStatus));
-            mqttClient->publish(topicCountOfDetectedPeopleInRange, String(countOfPeopleInRange));
+            mqttClient->publishState(topicMovementDetected, String(isMovingStatus));
+            mqttClient->publishState(topicCountOfDetectedPeopleInRange, String(countOfPeopleInRange));
             currentIsMovingStatus = isMovingStatus;
         }
     }
@@ -12,39 +12,78 @@
 #include "Defines.hpp"
 
 #ifdef USE_KY025
+#include "BinaryLog.hpp"
 #include "DebugHelper.hpp"
 #include "ReedContactKY025.hpp"
 
 #include <Arduino.h>
+#include <atomic>
+#ifdef USE_KY025_PCNT
+#include <driver/pcnt.h>
+#endif
 
 namespace IotZoo
 {
-    volatile unsigned long reedContactCounter    = 0;
-    volatile unsigned long lastRotationMillis    = 0;
-    volatile unsigned long diffMs                = 0;
-    volatile unsigned long oldReedContactCounter = 0;
+#ifdef USE_KY025_PCNT
+    static const pcnt_unit_t PcntUnit  = PCNT_UNIT_0;
+    static const int16_t     PcntLimit = 32767; // the counter restarts at 0 when it reaches the limit
+    // The glitch filter ignores pulses shorter than 1023 APB cycles (12.8 µs, the maximum). Longer contact bounce needs an
+    // RC filter at the pin.
+    static const uint16_t PcntFilterApbCycles = 1023;
+#else
+    static const unsigned long DebounceMs = 300;
 
-    double rpm = 0.0;
+    // Written by the interrupt, read by loop(). 32 bit atomics, so loop() never sees half of a value and needs no lock.
+    std::atomic<uint32_t> reedContactCounter{0};
+    std::atomic<uint32_t> reedContactPeriodMs{0}; // time between the last two pulses
+    unsigned long         lastRotationMillis = 0;
+    bool                  ledOn              = false;
 
     void IRAM_ATTR isrKY025()
     {
-        diffMs = millis() - lastRotationMillis;
-        if (diffMs > 300.0)
+        unsigned long now  = millis();
+        unsigned long diff = now - lastRotationMillis;
+        if (diff > DebounceMs)
         {
-            digitalWrite(2, !digitalRead(2));
-            reedContactCounter++;
-            rpm                = 1.0 / (diffMs / 60000.0);
-            lastRotationMillis = millis();
+            lastRotationMillis = now;
+            reedContactPeriodMs.store(diff, std::memory_order_relaxed);
+            reedContactCounter.fetch_add(1, std::memory_order_release);
+            ledOn = !ledOn;
+            digitalWrite(2, ledOn);
         }
     }
+#endif // USE_KY025_PCNT
 
     KY025::KY025(int deviceIndex, Settings* const settings, MqttClient* const mqttClient, const String& baseTopic, u16_t intervalMs, u8_t pinData)
         : DeviceBase(deviceIndex, settings, mqttClient, baseTopic)
     {
         Serial.println("Constructor KY025, intervalMs: " + String(intervalMs) + ", pinData: " + String(pinData));
         this->intervalMs = intervalMs;
+        topicRpm         = getBaseTopic() + "/reed_contact/" + String(deviceIndex) + "/rpm";
+        topicCounter     = getBaseTopic() + "/reed_contact/" + String(deviceIndex) + "/counter";
         pinMode(pinData, INPUT_PULLUP);
+#ifdef USE_KY025_PCNT
+        pcnt_config_t config = {};
+        config.pulse_gpio_num = pinData;
+        config.ctrl_gpio_num  = PCNT_PIN_NOT_USED;
+        config.channel        = PCNT_CHANNEL_0;
+        config.unit           = PcntUnit;
+        config.pos_mode       = PCNT_COUNT_DIS; // the contact pulls the pin low: count the falling edges
+        config.neg_mode       = PCNT_COUNT_INC;
+        config.lctrl_mode     = PCNT_MODE_KEEP;
+        config.hctrl_mode     = PCNT_MODE_KEEP;
+        config.counter_h_lim  = PcntLimit;
+        config.counter_l_lim  = 0;
+        pcnt_unit_config(&config);
+        pcnt_set_filter_value(PcntUnit, PcntFilterApbCycles);
+        pcnt_filter_enable(PcntUnit);
+        pcnt_counter_pause(PcntUnit);
+        pcnt_counter_clear(PcntUnit);
+        pcnt_counter_resume(PcntUnit);
+        windowStartMillis = millis();
+#else
         attachInterrupt(pinData, isrKY025, FALLING);
+#endif
     }
 
     void KY025::addMqttTopicsToRegister(std::vector<Topic>* const topics) const
@@ -56,48 +95,82 @@ namespace IotZoo
         topics->emplace_back(topic, String(44151), MessageDirection::IotZooClientInbound);
     }
 
-    bool KY025::setPayloadPropertyOfTopicLink(TopicLink& topicLink)
+    void KY025::publishValue(const String& topic, const String& value)
     {
-        bool handled = false;
-        if (DeviceBase::setPayloadPropertyOfTopicLink(topicLink))
-        {
-            handled = true;
-        }
-        else if (topicLink.TriggeringTopic.equalsIgnoreCase(getBaseTopic() + "/reed_contact/" + String(getDeviceIndex()) + "/rpm"))
+        mqttClient->publishState(topic, value);
+#ifdef USE_INTERNAL_MQTT
+        signalValueChanged(topic, value);
+#endif
+    }
+
+#ifdef USE_KY025_PCNT
+    void KY025::samplePulseCounter()
+    {
+        int16_t count = 0;
+        pcnt_get_counter_value(PcntUnit, &count);
+        uint32_t pulses = (count - lastCount + PcntLimit) % PcntLimit; // sampled long before PcntLimit pulses can pass
+        lastCount       = count;
+
+        unsigned long now = millis();
+        if (pulses > 0)
         {
-            topicLink.Payload = String(rpm, 0);
-            handled           = true;
+            if (lastPulseMillis != 0)
+            {
+                periodRpm = 60000.0f * pulses / (now - lastPulseMillis);
+            }
+            lastPulseMillis = now;
+            counter += pulses;
+            windowPulses += pulses;
         }
-        else if (topicLink.TriggeringTopic.equalsIgnoreCase(getBaseTopic() + "/reed_contact/" + String(getDeviceIndex()) + "/counter"))
+
+        if (now - windowStartMillis >= WindowMs)
         {
-            topicLink.Payload = String(reedContactCounter);
-            handled           = true;
+            if (windowPulses >= MinWindowPulses)
+            {
+                rpm = 60000.0f * windowPulses / (now - windowStartMillis);
+            }
+            else if (windowPulses > 0)
+            {
+                rpm = periodRpm;
+            }
+            else if (now - lastPulseMillis > StandstillMs)
+            {
+                rpm = 0;
+            }
+            windowStartMillis = now;
+            windowPulses      = 0;
         }
-        return handled;
     }
+#endif // USE_KY025_PCNT
 
     void KY025::loop()
     {
-        debug("KY025::loop oldCounter: " + String(oldReedContactCounter) + ", counter: " + String(reedContactCounter) + ", rpm: " + String(rpm, 0));
         DeviceBase::loop();
-        if (millis() - lastLoopMillis < 200)
+#ifdef USE_KY025_PCNT
+        samplePulseCounter();
+#else
+        counter           = reedContactCounter.load(std::memory_order_acquire);
+        uint32_t periodMs = reedContactPeriodMs.load(std::memory_order_relaxed);
+        rpm               = periodMs > 0 ? 60000.0f / periodMs : 0;
+#endif
+        logBinary("KY025::loop publishedCounter: %u, counter: %u, rpm: %.0f", publishedCounter, counter, rpm);
+        if (millis() - lastLoopMillis < PublishIntervalMs)
         {
-            debug("KY025 skip loop");
             return;
         }
 
-        if (oldReedContactCounter != reedContactCounter)
+        if (publishedCounter != counter)
         {
-            oldReedContactCounter = reedContactCounter;
-            mqttClient->publish(getBaseTopic() + "/reed_contact/" + String(getDeviceIndex()) + "/rpm", String(rpm, 0));
-            mqttClient->publish(getBaseTopic() + "/reed_contact/" + String(getDeviceIndex()) + "/counter", String(reedContactCounter));
+            publishedCounter = counter;
+            publishValue(topicRpm, String(rpm, 0));
+            publishValue(topicCounter, String(counter));
             lastLoopMillis = millis();
         }
         else
         {
-            if (millis() - lastLoopMillis > 3000)
+            if (millis() - lastLoopMillis > StandstillMs)
             {
-                mqttClient->publish(getBaseTopic() + "/reed_contact/" + String(getDeviceIndex()) + "/rpm", "0");
+                publishValue(topicRpm, "0");
                 lastLoopMillis = millis();
             }
         }
@@ -0,0 +1,110 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Sends WS2812/WS2818 frames with the RMT peripheral, without blocking the CPU or disabling the interrupts.
+// --------------------------------------------------------------------------------------------------------------------
+#include "Defines.hpp"
+#ifdef USE_WS2818_RMT
+#include "RmtPixelOutput.hpp"
+
+namespace IotZoo
+{
+    // The RMT counts with 80 MHz / 2 = 40 MHz, one tick is 25 ns.
+    static const uint8_t  ClockDivider = 2;
+    static const uint16_t T0H          = 16; // 0.4 µs high, 0.85 µs low for a 0 bit
+    static const uint16_t T0L          = 34;
+    static const uint16_t T1H          = 32; // 0.8 µs high, 0.45 µs low for a 1 bit
+    static const uint16_t T1L          = 18;
+    static const uint32_t ResetMicros  = 300; // low time that latches a frame: 50 µs for the WS2812, 280 µs for newer strips
+
+    RmtPixelOutput::RmtPixelOutput(uint8_t pin, size_t frameSize, rmt_channel_t channel) : channel(channel), frameSize(frameSize)
+    {
+        Serial.println("Constructor RmtPixelOutput, pin: " + String(pin) + ", frameSize: " + String(frameSize));
+        frames[0] = new uint8_t[frameSize]();
+        frames[1] = new uint8_t[frameSize]();
+
+        rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)pin, channel);
+        config.clk_div      = ClockDivider;
+        rmt_config(&config);
+        rmt_driver_install(channel, 0, 0);
+        rmt_translator_init(channel, translate);
+        rmt_register_tx_end_callback(onTransmissionEnd, this);
+    }
+
+    RmtPixelOutput::~RmtPixelOutput()
+    {
+        rmt_wait_tx_done(channel, portMAX_DELAY);
+        rmt_register_tx_end_callback(nullptr, nullptr);
+        rmt_driver_uninstall(channel);
+        delete[] frames[0];
+        delete[] frames[1];
+    }
+
+    bool RmtPixelOutput::send(size_t length)
+    {
+        if (busy.exchange(true, std::memory_order_acq_rel))
+        {
+            return false;
+        }
+        // The interrupt has stored the end time before it cleared busy.
+        uint32_t sinceFrameEndMicros = micros() - frameEndMicros.load(std::memory_order_relaxed);
+        if (sinceFrameEndMicros < ResetMicros)
+        {
+            delayMicroseconds(ResetMicros - sinceFrameEndMicros); // short frame intervals only
+        }
+        front = 1 - front;
+        if (length > frameSize)
+        {
+            length = frameSize;
+        }
+        // Does not wait: the driver refills the RMT memory from the front buffer in its interrupt.
+        if (rmt_write_sample(channel, frames[front], length, false) != ESP_OK)
+        {
+            busy.store(false, std::memory_order_release);
+            return false;
+        }
+        return true;
+    }
+
+    void IRAM_ATTR RmtPixelOutput::translate(const void* source, rmt_item32_t* destination, size_t sourceSize, size_t wantedItems,
+                                             size_t* translatedSize, size_t* itemCount)
+    {
+        const rmt_item32_t bit0 = {{{T0H, 1, T0L, 0}}};
+        const rmt_item32_t bit1 = {{{T1H, 1, T1L, 0}}};
+
+        const uint8_t* bytes = static_cast<const uint8_t*>(source);
+        size_t         size  = 0;
+        size_t         count = 0;
+        while (size < sourceSize && count + 8 <= wantedItems)
+        {
+            for (uint8_t mask = 0x80; mask != 0; mask >>= 1)
+            {
+                destination[count++].val = (bytes[size] & mask) ? bit1.val : bit0.val;
+            }
+            size++;
+        }
+        *translatedSize = size;
+        *itemCount      = count;
+    }
+
+    void RmtPixelOutput::onTransmissionEnd(rmt_channel_t channel, void* arg)
+    {
+        RmtPixelOutput* output = static_cast<RmtPixelOutput*>(arg);
+        if (nullptr == output || channel != output->channel)
+        {
+            return;
+        }
+        output->frameEndMicros.store(micros(), std::memory_order_relaxed);
+        output->busy.store(false, std::memory_order_release);
+        if (nullptr != output->frameSentCallback)
+        {
+            output->frameSentCallback(output->frameSentCallbackArg);
+        }
+    }
+} // namespace IotZoo
+#endif // USE_WS2818_RMT
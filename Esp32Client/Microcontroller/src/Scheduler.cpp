@@ -0,0 +1,133 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Cooperative scheduler for the main loop.
+// --------------------------------------------------------------------------------------------------------------------
+#include "Scheduler.hpp"
+#include "DeviceBase.hpp"
+
+#include <Arduino.h>
+#include <algorithm>
+#include <esp_timer.h>
+
+namespace IotZoo
+{
+    Scheduler::TaskId Scheduler::addTask(const String& name, Callback callback)
+    {
+        Serial.println("Scheduler: add task " + name);
+        tasks.emplace_back();
+        Task& task         = tasks.back();
+        task.name          = name;
+        task.callback      = callback;
+        task.nextRunMillis = millis();
+        publishedTasks.emplace_back();
+        publishedTasks.back().name = task.name.c_str();
+        return tasks.size() - 1;
+    }
+
+    Scheduler::TaskId Scheduler::addTask(const String& name, unsigned long intervalMs, std::function<void()> callback)
+    {
+        return addTask(name,
+                       [intervalMs, callback]()
+                       {
+                           callback();
+                           return intervalMs;
+                       });
+    }
+
+    Scheduler::TaskId Scheduler::addDevice(const String& name, DeviceBase* device)
+    {
+        TaskId taskId = addTask(name,
+                                [device]()
+                                {
+                                    device->loop();
+                                    return device->getLoopIntervalMs();
+                                });
+        device->setSchedulerTask(this, taskId);
+        return taskId;
+    }
+
+    unsigned long Scheduler::run(unsigned long maxIdleMs)
+    {
+        int64_t runStart = esp_timer_get_time();
+        for (auto& task : tasks)
+        {
+            if (!task.triggered && (long)(millis() - task.nextRunMillis) < 0)
+            {
+                continue;
+            }
+            task.triggered = false;
+
+            int64_t       start      = esp_timer_get_time();
+            unsigned long intervalMs = task.callback();
+            uint32_t      duration   = esp_timer_get_time() - start;
+
+            task.nextRunMillis = millis() + intervalMs;
+            task.runs++;
+            task.totalMicros += duration;
+            task.latestMicros = duration;
+            if (duration > task.worstMicros)
+            {
+                task.worstMicros = duration;
+            }
+        }
+        runHistogram.add(esp_timer_get_time() - runStart);
+
+        unsigned long now    = millis();
+        unsigned long idleMs = maxIdleMs;
+        for (const auto& task : tasks)
+        {
+            long remaining = (long)(task.nextRunMillis - now);
+            if (task.triggered || remaining <= 0)
+            {
+                return 0;
+            }
+            if ((unsigned long)remaining < idleMs)
+            {
+                idleMs = remaining;
+            }
+        }
+        return idleMs;
+    }
+
+    Scheduler::Statistics Scheduler::getStatistics() const
+    {
+        Statistics statistics;
+        statistics.runHistogram = runHistogram;
+        statistics.tasks.reserve(tasks.size());
+        for (const auto& task : tasks)
+        {
+            statistics.tasks.push_back({task.name.c_str(), task.runs, task.totalMicros, task.worstMicros});
+        }
+        return statistics;
+    }
+
+    void Scheduler::publishStatistics()
+    {
+        portENTER_CRITICAL(&statisticsLock);
+        publishedHistogram = runHistogram;
+        for (size_t index = 0; index < tasks.size(); index++)
+        {
+            publishedTasks[index].runs        = tasks[index].runs;
+            publishedTasks[index].totalMicros = tasks[index].totalMicros;
+            publishedTasks[index].worstMicros = tasks[index].worstMicros;
+        }
+        portEXIT_CRITICAL(&statisticsLock);
+    }
+
+    Scheduler::Statistics Scheduler::getPublishedStatistics() const
+    {
+        Statistics statistics;
+        statistics.tasks.resize(publishedTasks.size()); // allocates outside of the critical section
+        portENTER_CRITICAL(&statisticsLock);
+        statistics.runHistogram = publishedHistogram;
+        std::copy(publishedTasks.begin(), publishedTasks.end(), statistics.tasks.begin());
+        portEXIT_CRITICAL(&statisticsLock);
+        return statistics;
+    }
+} // namespace IotZoo
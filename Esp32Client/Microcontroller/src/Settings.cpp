@@ -23,11 +23,148 @@ namespace IotZoo
             Serial.println("Settings failure!");
         }
         preferences.end();
+
+        // Read the settings used at runtime into RAM.
+        getEntry("interval_alive", EntryType::Long, 15000);
+        getEntry("alive_led", EntryType::UShort, 2);
+        getEntry("MqttBrokerIp", EntryType::Text);
+        getEntry("NamespaceName", EntryType::Text);
+        getEntry("ProjectName", EntryType::Text);
     }
 
     Settings::~Settings()
     {
         Serial.println("Destructor Settings");
+        flush();
+    }
+
+    Settings::Entry& Settings::getEntry(const String& key, EntryType type, long fallbackNumber)
+    {
+        std::lock_guard<std::recursive_mutex> lock(entriesLock);
+        auto it = entries.find(key);
+        if (it != entries.end())
+        {
+            return it->second;
+        }
+
+        Entry& entry = entries[key];
+        entry.type   = type;
+        entry.number = fallbackNumber;
+        if (!preferences.begin(NamespaceNameConfig, true))
+        {
+            Serial.println("namespace not found in config");
+            return entry;
+        }
+        switch (type)
+        {
+        case EntryType::Text:
+            entry.text = preferences.getString(key.c_str(), "");
+            break;
+        case EntryType::Long:
+            entry.number = preferences.getLong(key.c_str(), fallbackNumber);
+            break;
+        case EntryType::UShort:
+            entry.number = preferences.getUShort(key.c_str(), fallbackNumber);
+            break;
+        }
+        preferences.end();
+        return entry;
+    }
+
+    long Settings::getNumber(const String& key, EntryType type, long fallbackNumber)
+    {
+        std::lock_guard<std::recursive_mutex> lock(entriesLock);
+        return getEntry(key, type, fallbackNumber).number;
+    }
+
+    void Settings::setText(const String& key, const String& text)
+    {
+        std::lock_guard<std::recursive_mutex> lock(entriesLock);
+        Entry& entry = getEntry(key, EntryType::Text);
+        if (entry.text == text)
+        {
+            return; // unchanged, do not wear the flash
+        }
+        entry.text       = text;
+        entry.dirty      = true;
+        hasDirtyEntries  = true;
+        lastChangeMillis = millis();
+    }
+
+    void Settings::setNumber(const String& key, EntryType type, long number)
+    {
+        std::lock_guard<std::recursive_mutex> lock(entriesLock);
+        bool   isCached = entries.find(key) != entries.end();
+        Entry& entry    = getEntry(key, type, number);
+        if (isCached && entry.number == number)
+        {
+            return; // unchanged, do not wear the flash
+        }
+        entry.number     = number;
+        entry.dirty      = true;
+        hasDirtyEntries  = true;
+        lastChangeMillis = millis();
+    }
+
+    void Settings::loop()
+    {
+        std::lock_guard<std::recursive_mutex> lock(entriesLock);
+        if (hasDirtyEntries && millis() - lastChangeMillis > FlushDelayMs)
+        {
+            flush();
+        }
+    }
+
+    bool Settings::flush()
+    {
+        std::lock_guard<std::recursive_mutex> lock(entriesLock);
+        if (!hasDirtyEntries)
+        {
+            return true;
+        }
+        hasDirtyEntries = false;
+
+        if (!preferences.begin(NamespaceNameConfig, false))
+        {
+            Serial.println("Settings failure! Changed settings are not saved.");
+            return false;
+        }
+        bool ok = true;
+        for (auto& keyAndEntry : entries)
+        {
+            Entry& entry = keyAndEntry.second;
+            if (!entry.dirty)
+            {
+                continue;
+            }
+            entry.dirty         = false;
+            const char* key     = keyAndEntry.first.c_str();
+            size_t      written = 0;
+            size_t      size    = 0;
+            switch (entry.type)
+            {
+            case EntryType::Text:
+                written = preferences.putString(key, entry.text);
+                size    = entry.text.length();
+                break;
+            case EntryType::Long:
+                written = preferences.putLong(key, entry.number);
+                size    = sizeof(int32_t);
+                break;
+            case EntryType::UShort:
+                written = preferences.putUShort(key, entry.number);
+                size    = sizeof(uint16_t);
+                break;
+            }
+            if (written != size)
+            {
+                Serial.println("Setting '" + keyAndEntry.first + "' not saved!");
+                ok = false;
+            }
+        }
+        preferences.end();
+        Serial.println("Settings saved.");
+        return ok;
     }
 
     void Settings::saveDeviceConfigurations(const String& json)
@@ -42,31 +179,19 @@ namespace IotZoo
         {
             return;
         }
-        preferences.begin(NamespaceNameConfig, false);
-        int bytesWritten = preferences.putString(key.c_str(), data);
-        Serial.print("Bytes written: " + String(bytesWritten));
-        if (bytesWritten == data.length())
-        {
-            Serial.println(" (ok)");
-        }
-        preferences.end();
-        Serial.println("Check: " + loadConfiguration(key));
+        setText(key, data);
     }
 
     String Settings::loadConfiguration(const String& key)
     {
         Serial.println("load configuration. key: " + key + ", NamespaceNameConfig: " + NamespaceNameConfig);
 
-        if (!preferences.begin(NamespaceNameConfig, true))
+        String data;
         {
-            Serial.println("namespace not found in config");
-            return "";
+            std::lock_guard<std::recursive_mutex> lock(entriesLock);
+            data = getEntry(key, EntryType::Text).text;
         }
-
-        String data = preferences.getString(key.c_str(), "");
         Serial.println("Loaded data: " + data);
-
-        preferences.end();
         return data;
     }
 
@@ -78,54 +203,31 @@ namespace IotZoo
     // gets the interval for sending alive message via mqtt.
     long Settings::getAliveIntervalMillis()
     {
-        preferences.begin(NamespaceNameConfig, true);
-        long interval = preferences.getLong("interval_alive", 15000);
-        preferences.end();
-        return interval;
+        return getNumber("interval_alive", EntryType::Long, 15000);
     }
 
     void Settings::setAliveIntervalMillis(long interval)
     {
-        preferences.begin(NamespaceNameConfig, false);
-        preferences.putLong("interval_alive", interval);
-        preferences.end();
+        setNumber("interval_alive", EntryType::Long, interval);
     }
 
-    // 0 = off, 1 = on, 2 = turned on during the day 
+    // 0 = off, 1 = on, 2 = turned on during the day
     short Settings::getAliveAckLedMode()
     {
-        preferences.begin(NamespaceNameConfig, true);       
-        short isActive = preferences.getUShort("alive_led", 2); // default = turned on during the day (off at night)
-        preferences.end();
-        return isActive;
+        return getNumber("alive_led", EntryType::UShort, 2); // default = turned on during the day (off at night)
     }
 
     bool Settings::setAliveLedMode(short aliveLedMode)
     {
-        preferences.begin(NamespaceNameConfig, false);
-        bool ok = preferences.getUShort("alive_led", aliveLedMode) == aliveLedMode;
-        preferences.end();
-        return ok;
+        setNumber("alive_led", EntryType::UShort, aliveLedMode);
+        return true;
     }
 
     bool Settings::storeData(const String& key, const String& data)
     {
-        try
-        {
-            Serial.println("storeData to '" + key + "' data: '" + data + "'");
-            int size = 0;
-            if (preferences.begin(NamespaceNameConfig, false))
-            {
-                size = preferences.putString(key.c_str(), data);
-                preferences.end();
-            }
-            return size == data.length();
-        }
-        catch (const std::exception& e)
-        {
-            Serial.println(e.what()); // Exception handling does only work with build_flags -DPIO_FRAMEWORK_ARDUINO_ENABLE_EXCEPTIONS
-            return false;
-        }
+        Serial.println("storeData to '" + key + "' data: '" + data + "'");
+        setText(key, data);
+        return true;
     }
 
     String Settings::getDataString(const String& key, const String& fallbackValue, bool printLog /*= true*/)
@@ -136,26 +238,11 @@ namespace IotZoo
         }
 
         String data;
-        try
-        {
-            if (preferences.begin(NamespaceNameConfig, true))
-            {
-                data = preferences.getString(key.c_str(),
-                                             fallbackValue); // fallback
-            }
-            preferences.end();
-            if (data == "null")
-            {
-                Serial.println("Using fallback '" + fallbackValue + "'!");
-                return fallbackValue;
-            }
-        }
-        catch (const std::exception& e)
         {
-            Serial.println(e.what()); // Exception handling does only work with build_flags -DPIO_FRAMEWORK_ARDUINO_ENABLE_EXCEPTIONS
-            return fallbackValue;
+            std::lock_guard<std::recursive_mutex> lock(entriesLock);
+            data = getEntry(key, EntryType::Text).text;
         }
-        if (data.length() == 0)
+        if (data.length() == 0 || data == "null")
         {
             Serial.println("Using fallback '" + fallbackValue + "'!");
             return fallbackValue;
@@ -203,16 +290,11 @@ namespace IotZoo
 
     long Settings::getIntervalTemperatureSensorsMillis()
     {
-        preferences.begin(NamespaceNameConfig, true);
-        long interval = preferences.getLong("interval_temperature_sensors", 30000);
-        preferences.end();
-        return interval;
+        return getNumber("interval_temperature_sensors", EntryType::Long, 30000);
     }
 
     void Settings::setIntervalTemperatureSensorsMillis(long interval)
     {
-        preferences.begin(NamespaceNameConfig, false);
-        preferences.putLong("interval_temperature_sensors", interval);
-        preferences.end();
+        setNumber("interval_temperature_sensors", EntryType::Long, interval);
     }
-} // namespace IotZoo
\ No newline at end of file
+} // namespace IotZoo
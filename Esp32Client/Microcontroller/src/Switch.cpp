@@ -18,6 +18,8 @@ namespace IotZoo
         : DeviceBase(deviceIndex, settings, mqttClient, baseTopic)
     {
         this->pin = pin;
+        topicOn   = getBaseTopic() + "/switch/" + String(deviceIndex) + "/on";
+        topicOff  = getBaseTopic() + "/switch/" + String(deviceIndex) + "/off";
         Serial.println("Constructor Switch. Pin: " + String(pin));
         pinMode(pin, INPUT_PULLUP);
     }
@@ -63,18 +65,15 @@ namespace IotZoo
     {
         if (hasStateChanged())
         {
-            String topicButton = getBaseTopic() + "/switch/" + String(getDeviceIndex());
             if (isPressed())
             {
                 Serial.println("Switch at Pin + " + String(getPin()) + " changed state to on. Payload: millis on ESP32.");
-                topicButton += "/on";
-                mqttClient->publish(topicButton, String(millis()));
+                mqttClient->publish(topicOn, String(millis()));
             }
             else
             {
                 Serial.println("Switch at Pin + " + String(getPin()) + " changed state to off. Payload: millis on ESP32.");
-                topicButton += "/off";
-                mqttClient->publish(topicButton, String(millis()));
+                mqttClient->publish(topicOff, String(millis()));
             }
         }
     }
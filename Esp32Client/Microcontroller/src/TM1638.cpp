@@ -20,6 +20,7 @@ namespace IotZoo
         : DeviceBase(deviceIndex, settings, mqttClient, baseTopic)
     {
         Serial.println("Constructor TM1638");
+        topicButtonRowState = getBaseTopic() + "/ledAndKey/button_row/state";
         tm1638plus = new TM1638plus(strobe, clock, data, highfreq);
         tm1638plus->displayBegin();
     }
@@ -142,8 +143,7 @@ namespace IotZoo
             lastButtonsState = buttonsState;
             tm1638plus->displayIntNum(buttonsState, true, TMAlignTextLeft);
 #ifdef USE_MQTT
-            String topicLedAndKeyButtonState = getBaseTopic() + "/ledAndKey/button_row/state";
-            mqttClient->publish(topicLedAndKeyButtonState, String(buttonsState));
+            mqttClient->publishState(topicButtonRowState, String(buttonsState));
 #endif
         }
     }
@@ -0,0 +1,195 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Condition of a TopicLink, compiled once from its json Expression.
+// --------------------------------------------------------------------------------------------------------------------
+#include "TopicLinkExpression.hpp"
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <stdlib.h>
+
+namespace IotZoo
+{
+    namespace
+    {
+        using Operator  = TopicLinkExpression::Operator;
+        using Condition = TopicLinkExpression::Condition;
+
+        struct OperatorToken
+        {
+            const char* token;
+            Operator    op;
+        };
+
+        const OperatorToken operatorTokens[] = {{"<", Operator::Less},         {"<=", Operator::LessOrEqual}, {">", Operator::Greater},
+                                                {">=", Operator::GreaterOrEqual}, {"==", Operator::Equal},       {"=", Operator::Equal},
+                                                {"!=", Operator::NotEqual},       {"<>", Operator::NotEqual}};
+
+        // Result of each operator (indexed by Operator) when the payload is less than, equal to or greater than the value.
+        const bool accepts[][3] = {
+            {true, true, true},    // Always
+            {false, false, false}, // Never
+            {true, false, false},  // Less
+            {true, true, false},   // LessOrEqual
+            {false, false, true},  // Greater
+            {false, true, true},   // GreaterOrEqual
+            {false, true, false},  // Equal
+            {true, false, true},   // NotEqual
+        };
+
+        bool parseNumber(const String& text, double& number)
+        {
+            const char* begin = text.c_str();
+            char*       end   = nullptr;
+            number            = strtod(begin, &end);
+            return end != begin && *end == '\0';
+        }
+
+        bool compileCondition(JsonVariantConst json, bool startsGroup, std::vector<Condition>& conditions)
+        {
+            Condition condition;
+            condition.startsGroup = startsGroup;
+
+            String strOperator = json["Operator"].as<String>();
+            strOperator.trim();
+            bool found = false;
+            for (const auto& operatorToken : operatorTokens)
+            {
+                if (strOperator == operatorToken.token)
+                {
+                    condition.op = operatorToken.op;
+                    found        = true;
+                    break;
+                }
+            }
+            if (!found)
+            {
+                Serial.println("⚠️ TopicLink expression: unknown operator '" + strOperator + "'");
+                return false;
+            }
+
+            JsonVariantConst value = json["Value"];
+            if (value.is<double>())
+            {
+                condition.value = value.as<double>();
+            }
+            else
+            {
+                condition.text = value.as<String>();
+                condition.text.trim();
+                condition.numeric = parseNumber(condition.text, condition.value);
+            }
+            conditions.push_back(condition);
+            return true;
+        }
+
+        bool compileAnd(JsonVariantConst json, bool startsGroup, std::vector<Condition>& conditions)
+        {
+            if (!json["And"].is<JsonArrayConst>())
+            {
+                return compileCondition(json, startsGroup, conditions);
+            }
+            JsonArrayConst arrConditions = json["And"].as<JsonArrayConst>();
+            if (arrConditions.size() == 0)
+            {
+                return false;
+            }
+            for (JsonVariantConst condition : arrConditions)
+            {
+                if (!compileCondition(condition, startsGroup, conditions))
+                {
+                    return false;
+                }
+                startsGroup = false;
+            }
+            return true;
+        }
+    } // namespace
+
+    bool TopicLinkExpression::Condition::test(const String& payload, double number) const
+    {
+        uint8_t order; // 0: payload < value, 1: payload == value, 2: payload > value
+        if (numeric)
+        {
+            order = number < value ? 0 : (number == value ? 1 : 2);
+        }
+        else
+        {
+            int compare = payload.compareTo(text);
+            order       = compare < 0 ? 0 : (compare == 0 ? 1 : 2);
+        }
+        return accepts[static_cast<uint8_t>(op)][order];
+    }
+
+    TopicLinkExpression TopicLinkExpression::compile(const String& expression)
+    {
+        TopicLinkExpression compiled;
+        if (expression.length() == 0 || expression.equalsIgnoreCase("null"))
+        {
+            return compiled; // no expression means "always publish"
+        }
+
+        StaticJsonDocument<512> jsonDocument;
+        DeserializationError    error = deserializeJson(jsonDocument, expression);
+        bool                    ok    = !error;
+        if (ok)
+        {
+            JsonVariantConst json = jsonDocument.as<JsonVariantConst>();
+            if (json["Or"].is<JsonArrayConst>())
+            {
+                JsonArrayConst arrAlternatives = json["Or"].as<JsonArrayConst>();
+                ok                             = arrAlternatives.size() > 0;
+                for (JsonVariantConst alternative : arrAlternatives)
+                {
+                    ok = ok && compileAnd(alternative, true, compiled.conditions);
+                }
+            }
+            else
+            {
+                ok = compileAnd(json, true, compiled.conditions);
+            }
+        }
+        else
+        {
+            Serial.println("⚠️ TopicLink expression '" + expression + "' is not valid json: " + String(error.c_str()));
+        }
+
+        if (!ok)
+        {
+            Serial.println("⚠️ TopicLink expression '" + expression + "' can never be true.");
+            compiled.conditions.assign(1, Condition());
+            compiled.conditions[0].op = Operator::Never;
+        }
+        return compiled;
+    }
+
+    bool TopicLinkExpression::evaluate(const String& payload) const
+    {
+        if (conditions.empty())
+        {
+            return true;
+        }
+        double number = payload.toDouble();
+        bool   group  = true;
+        for (size_t i = 0; i < conditions.size(); i++)
+        {
+            const Condition& condition = conditions[i];
+            if (condition.startsGroup && i > 0)
+            {
+                if (group)
+                {
+                    return true; // previous alternative is true
+                }
+                group = true;
+            }
+            group = group && condition.test(payload, number);
+        }
+        return group;
+    }
+} // namespace IotZoo
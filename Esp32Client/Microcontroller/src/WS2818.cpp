@@ -14,6 +14,9 @@
 #ifdef USE_WS2818
 #include "WS2818.hpp"
 
+#include <algorithm>
+#include <mbedtls/base64.h>
+
 namespace IotZoo
 {
     WS2818::WS2818(int deviceIndex, Settings* const settings, MqttClient* const mqttClient, const String& baseTopic, uint pin, uint numberOfLeds)
@@ -30,6 +33,10 @@ namespace IotZoo
     WS2818::~WS2818()
     {
         Serial.println("Destructor WS2818");
+#ifdef USE_WS2818_RMT
+        delete output;
+        output = nullptr;
+#endif
         delete pixels;
         pixels = nullptr;
     }
@@ -44,32 +51,183 @@ namespace IotZoo
             pixelProperties[index].PixelId            = index;
             pixelProperties[index].MillisUntilTurnOff = 0;
         }
+        colors.assign(this->numberOfLeds, 0);
 
         pixels->begin();
         pixels->clear();
+#ifdef USE_WS2818_RMT
+        output = new RmtPixelOutput(dioPin, numberOfLeds * BytesPerPixel);
+        output->setFrameSentCallback(onFrameSent, this);
+#endif
+        markDirty(0, numberOfLeds - 1);
         Serial.println("WS2818 setup done.");
     }
 
     void WS2818::loop()
     {
-        // Reset pixel color
-        for (auto& pixelProperty : pixelProperties)
+        unsigned long now = millis();
+        turnOffExpiredPixels(now);
+
+        uint16_t first;
+        uint16_t last;
+        if (pixelEffects.render(now, frameIntervalMs, colors.data(), numberOfLeds, first, last))
         {
-            // Serial.println("index:" + String(pixelProperty.PixelId) + ", MillisUntilTurnOff: " +
-            //                String(pixelProperties[pixelProperty.PixelId].MillisUntilTurnOff) + ", CurrentMillis: " + String(millis()));
+            markDirty(first, last, false);
+        }
 
-            if (pixelProperty.MillisUntilTurnOff == 0)
+        if (dirty && now - lastShowMillis >= frameIntervalMs)
+        {
+            logDebug("WS2818 show, changed pixels " << dirtyFirst << " - " << dirtyLast);
+            encode(dirtyFirst, dirtyLast);
+            if (show())
             {
-                continue;
+                lastShowMillis = now;
+                dirty          = false;
             }
-            if (millis() > pixelProperty.MillisUntilTurnOff)
+        }
+    }
+
+    void WS2818::encode(uint16_t first, uint16_t last)
+    {
+        for (uint16_t index = first; index <= last; index++)
+        {
+            uint32_t color = colors[index];
+            uint8_t  r     = color >> 16;
+            uint8_t  g     = color >> 8;
+            uint8_t  b     = color;
+            if (gammaCorrection)
             {
-                // turn the pixel off.
-                pixels->setPixelColor(pixelProperty.PixelId, 0);
-                pixelProperties[pixelProperty.PixelId].MillisUntilTurnOff = 0;
+                r = GammaTable[r];
+                g = GammaTable[g];
+                b = GammaTable[b];
             }
+            // like Adafruit_NeoPixel::setBrightness(), but per pixel and only for the changed ones
+            uint16_t scale = pixelProperties[index].Brightness + 1;
+            pixels->setPixelColor(index, (r * scale) >> 8, (g * scale) >> 8, (b * scale) >> 8);
+        }
+    }
+
+    bool WS2818::show()
+    {
+#ifdef USE_WS2818_RMT
+        if (output->isBusy())
+        {
+            return false; // onFrameSent() calls loop() again
         }
+        // A strip passes on everything behind the first pixels, the pixels behind the last changed one keep their color.
+        size_t length = (dirtyLast + 1) * BytesPerPixel;
+        memcpy(output->getBackBuffer(), pixels->getPixels(), length);
+        return output->send(length);
+#else
         pixels->show();
+        return true;
+#endif
+    }
+
+#ifdef USE_WS2818_RMT
+    void WS2818::onFrameSent(void* arg)
+    {
+        static_cast<WS2818*>(arg)->requestLoop();
+    }
+#endif
+
+    unsigned long WS2818::getLoopIntervalMs() const
+    {
+        unsigned long now        = millis();
+        unsigned long intervalMs = IdleIntervalMs;
+#ifdef USE_WS2818_RMT
+        if (dirty && !output->isBusy()) // while busy, onFrameSent() calls loop()
+#else
+        if (dirty)
+#endif
+        {
+            unsigned long sinceShowMs = now - lastShowMillis;
+            intervalMs                = sinceShowMs >= frameIntervalMs ? 0 : frameIntervalMs - sinceShowMs;
+        }
+        if (!pixelEffects.isEmpty())
+        {
+            intervalMs = std::min(intervalMs, pixelEffects.getMillisUntilNextFrame(now));
+        }
+        if (!timeouts.empty())
+        {
+            long untilTimeoutMs = (long)(timeouts.top().MillisUntilTurnOff - now);
+            if (untilTimeoutMs <= 0)
+            {
+                return 0;
+            }
+            if ((unsigned long)untilTimeoutMs < intervalMs)
+            {
+                intervalMs = untilTimeoutMs;
+            }
+        }
+        return intervalMs;
+    }
+
+    void WS2818::setMaxFps(int maxFps)
+    {
+        if (maxFps < 1 || maxFps > MaxFpsLimit)
+        {
+            publishError("maxFps " + String(maxFps) + " out of range (1 ... " + String(MaxFpsLimit) + ")");
+            maxFps = std::clamp(maxFps, 1, MaxFpsLimit);
+        }
+        frameIntervalMs = 1000 / maxFps;
+    }
+
+    void WS2818::setGammaCorrection(bool on)
+    {
+        if (gammaCorrection != on)
+        {
+            gammaCorrection = on;
+            markDirty(0, numberOfLeds - 1);
+        }
+    }
+
+    void WS2818::setBrightness(uint16_t startIndex, uint16_t length, uint8_t brightness)
+    {
+        if (startIndex >= numberOfLeds || length == 0)
+        {
+            return;
+        }
+        uint16_t last = std::min<uint32_t>(startIndex + length, numberOfLeds) - 1;
+        for (uint16_t index = startIndex; index <= last; index++)
+        {
+            pixelProperties[index].Brightness = brightness;
+        }
+        markDirty(startIndex, last);
+    }
+
+    void WS2818::markDirty(uint16_t first, uint16_t last, bool wakeUp)
+    {
+        if (!dirty)
+        {
+            dirty      = true;
+            dirtyFirst = first;
+            dirtyLast  = last;
+            if (wakeUp)
+            {
+                requestLoop();
+            }
+            return;
+        }
+        dirtyFirst = std::min(dirtyFirst, first);
+        dirtyLast  = std::max(dirtyLast, last);
+    }
+
+    void WS2818::turnOffExpiredPixels(unsigned long now)
+    {
+        while (!timeouts.empty() && (long)(now - timeouts.top().MillisUntilTurnOff) >= 0)
+        {
+            PixelTimeout   timeout       = timeouts.top();
+            PixelProperty& pixelProperty = pixelProperties[timeout.PixelId];
+            timeouts.pop();
+            if (pixelProperty.MillisUntilTurnOff != timeout.MillisUntilTurnOff)
+            {
+                continue; // stale, the pixel was set again
+            }
+            colors[timeout.PixelId]          = 0;
+            pixelProperty.MillisUntilTurnOff = 0;
+            markDirty(timeout.PixelId, timeout.PixelId, false);
+        }
     }
 
     // @brief Example: iotzoo/esp32/08:D1:F9:E0:31:78/neo/0/setPixelColor
@@ -209,17 +367,26 @@ namespace IotZoo
                     millisUntilTurnOff = millisUntilTurnOffPropertyGlobal;
                 }
 
+                u_int8_t pixelBrightness = brightness;
+                if (pixel["brightness"] != nullptr)
+                {
+                    pixelBrightness = pixel["brightness"].as<u_int8_t>();
+                    if (pixelBrightness == 1)
+                    {
+                        pixelBrightness = 2;
+                    }
+                }
+
                 u_int32_t color = stoi(colorHex.c_str(), 0, 16);
 
                 Serial.println("setPixelColor colorHex: " + String(colorHex) + ", color: " + String(color) + ", startIndex: " + String(startIndex) +
-                               ", brightness: " + brightness + ", length: " + String(length) + ", MillisUntilTurnOff: " + String(millisUntilTurnOff));
+                               ", brightness: " + pixelBrightness + ", length: " + String(length) + ", MillisUntilTurnOff: " + String(millisUntilTurnOff));
 
                 for (u_int16_t index = startIndex; index < startIndex + length; index++)
                 {
-                    setPixelColor(color, index, brightness, millisUntilTurnOff);
+                    setPixelColor(color, index, pixelBrightness, millisUntilTurnOff);
                 }
             }
-            pixels->show();
         }
         catch (const std::exception& e)
         {
@@ -227,6 +394,257 @@ namespace IotZoo
         }
     }
 
+    static uint32_t parseColorHex(String colorHex)
+    {
+        if (colorHex.startsWith("#"))
+        {
+            colorHex = colorHex.substring(1);
+        }
+        return stoi(colorHex.c_str(), 0, 16);
+    }
+
+    void WS2818::startEffect(const String& json)
+    {
+        try
+        {
+            Serial.println("startEffect rawData: " + json);
+            StaticJsonDocument<512> jsonDocument;
+            if (!deserializeStaticJsonAndPublishError(jsonDocument, json))
+            {
+                return;
+            }
+
+            String effectName = jsonDocument["effect"].as<String>();
+            if (effectName == "stop")
+            {
+                stopEffects();
+                return;
+            }
+
+            PixelEffect effect;
+            if (effectName == "fade")
+            {
+                effect.Type = PixelEffectType::Fade;
+            }
+            else if (effectName == "blink")
+            {
+                effect.Type = PixelEffectType::Blink;
+            }
+            else if (effectName == "chase")
+            {
+                effect.Type = PixelEffectType::Chase;
+            }
+            else if (effectName == "breathe")
+            {
+                effect.Type = PixelEffectType::Breathe;
+            }
+            else if (effectName == "gradient")
+            {
+                effect.Type = PixelEffectType::Gradient;
+            }
+            else if (effectName == "scroll")
+            {
+                effect.Type = PixelEffectType::Scroll;
+            }
+            else
+            {
+                publishError("unknown effect " + effectName);
+                return;
+            }
+
+            // Read wider than the fields of PixelEffect, so a too large value is an error instead of being truncated.
+            uint32_t startIndex = jsonDocument["index"].as<uint32_t>();
+            uint32_t length     = jsonDocument["length"] != nullptr ? jsonDocument["length"].as<uint32_t>() : numberOfLeds - startIndex;
+            if (startIndex >= numberOfLeds || length == 0)
+            {
+                publishError("index out of range");
+                return;
+            }
+            effect.StartIndex = startIndex;
+            effect.Length     = std::min<uint32_t>(length, numberOfLeds - startIndex);
+            if (jsonDocument["color"] != nullptr)
+            {
+                effect.Color = parseColorHex(jsonDocument["color"].as<String>());
+            }
+            if (jsonDocument["color2"] != nullptr)
+            {
+                effect.Color2 = parseColorHex(jsonDocument["color2"].as<String>());
+            }
+            uint32_t number = 0;
+            if (jsonDocument["periodMs"] != nullptr)
+            {
+                if (!getEffectProperty(jsonDocument["periodMs"], "periodMs", 1, UINT16_MAX, number))
+                {
+                    return;
+                }
+                effect.PeriodMs = number;
+            }
+            if (jsonDocument["durationMs"] != nullptr)
+            {
+                effect.DurationMs = jsonDocument["durationMs"].as<uint32_t>();
+            }
+            if (jsonDocument["opacity"] != nullptr)
+            {
+                if (!getEffectProperty(jsonDocument["opacity"], "opacity", 0, UINT8_MAX, number))
+                {
+                    return;
+                }
+                effect.Opacity = number;
+            }
+            if (jsonDocument["width"] != nullptr)
+            {
+                if (!getEffectProperty(jsonDocument["width"], "width", 1, UINT8_MAX, number))
+                {
+                    return;
+                }
+                effect.Width = number;
+            }
+            if (jsonDocument["brightness"] != nullptr)
+            {
+                if (!getEffectProperty(jsonDocument["brightness"], "brightness", 0, UINT8_MAX, number))
+                {
+                    return;
+                }
+                if (number != 0) // 0: keeps the brightness of the pixels
+                {
+                    setBrightness(effect.StartIndex, effect.Length, number);
+                }
+            }
+
+            if (!startEffect(effect))
+            {
+                publishError("too many effects, max. " + String(PixelEffects::MaxEffects));
+            }
+        }
+        catch (const std::exception& e)
+        {
+            publishError(e.what());
+        }
+    }
+
+    bool WS2818::getEffectProperty(JsonVariantConst property, const char* name, uint32_t min, uint32_t max, uint32_t& number)
+    {
+        double value = property.as<double>(); // as<uint32_t>() would return 0 for -1 or 5000000000
+        if (value < min || value > max)
+        {
+            publishError(String(name) + " " + property.as<String>() + " out of range (" + String(min) + " ... " + String(max) + ")");
+            return false;
+        }
+        number = value;
+        return true;
+    }
+
+    bool WS2818::startEffect(const PixelEffect& effect)
+    {
+        if (!pixelEffects.start(effect))
+        {
+            return false;
+        }
+        requestLoop();
+        return true;
+    }
+
+    void WS2818::stopEffects()
+    {
+        pixelEffects.stop();
+    }
+
+    void WS2818::setPixelsByFrame(const String& base64)
+    {
+        size_t length = 0;
+        frameBuffer.resize(base64.length() / 4 * 3 + 3);
+        if (mbedtls_base64_decode(frameBuffer.data(), frameBuffer.size(), &length, (const unsigned char*)base64.c_str(), base64.length()) != 0)
+        {
+            publishError("frame: invalid Base64");
+            return;
+        }
+        setPixelsByFrame(frameBuffer.data(), length);
+    }
+
+    bool WS2818::setPixelsByFrame(const uint8_t* frame, size_t length)
+    {
+        const size_t HeaderSize = 5;
+        if (length < HeaderSize)
+        {
+            publishError("frame: too short");
+            return false;
+        }
+        bool     rle        = frame[0] & FrameFormatRle;
+        uint8_t  format     = frame[0] & ~FrameFormatRle;
+        uint16_t startIndex = frame[1] | frame[2] << 8;
+        uint16_t count      = frame[3] | frame[4] << 8;
+        if (format != FrameFormatRgb && format != FrameFormatPalette)
+        {
+            publishError("frame: unknown format " + String(format));
+            return false;
+        }
+        if (count == 0 || startIndex + count > numberOfLeds)
+        {
+            publishError("frame: pixels out of range");
+            return false;
+        }
+
+        size_t         offset      = HeaderSize;
+        const uint8_t* palette     = nullptr;
+        uint16_t       paletteSize = 0;
+        if (format == FrameFormatPalette)
+        {
+            paletteSize = offset < length && frame[offset] != 0 ? frame[offset] : 256;
+            offset++;
+            palette = frame + offset;
+            offset += paletteSize * 3;
+            if (offset > length)
+            {
+                publishError("frame: palette incomplete");
+                return false;
+            }
+        }
+        const size_t pixelSize = format == FrameFormatRgb ? 3 : 1;
+
+        // Calls visit(pixel data, position, run length) for each run; a pixel without RLE is a run of 1.
+        auto forEachRun = [&](auto visit) -> bool
+        {
+            size_t position = 0;
+            size_t index    = offset;
+            while (index < length)
+            {
+                uint16_t runLength = 1;
+                if (rle)
+                {
+                    runLength = frame[index++];
+                }
+                if (runLength == 0 || index + pixelSize > length || position + runLength > count || !visit(frame + index, position, runLength))
+                {
+                    return false;
+                }
+                index += pixelSize;
+                position += runLength;
+            }
+            return position == count;
+        };
+
+        // Check everything first, an invalid frame must not change any pixel.
+        if (!forEachRun([&](const uint8_t* data, size_t, uint16_t) { return format == FrameFormatRgb || data[0] < paletteSize; }))
+        {
+            publishError("frame: length does not match the number of pixels, or invalid color index");
+            return false;
+        }
+
+        forEachRun(
+            [&](const uint8_t* data, size_t position, uint16_t runLength)
+            {
+                const uint8_t* rgb = format == FrameFormatRgb ? data : palette + data[0] * 3;
+                for (uint16_t index = startIndex + position; index < startIndex + position + runLength; index++)
+                {
+                    colors[index]                             = Adafruit_NeoPixel::Color(rgb[0], rgb[1], rgb[2]);
+                    pixelProperties[index].MillisUntilTurnOff = 0;
+                }
+                return true;
+            });
+        markDirty(startIndex, startIndex + count - 1);
+        return true;
+    }
+
     void WS2818::setPixelsByPreset(const String& presetName)
     {
         try
@@ -287,6 +705,13 @@ namespace IotZoo
 
         topics->emplace_back(getBaseTopic() + "/" + deviceName + "/0/setPixelColor", jsonExampleColorHex, MessageDirection::IotZooClientOutbound);
         topics->emplace_back(getBaseTopic() + "/" + deviceName + "/0/setPixelsByPreset", "Smiley", MessageDirection::IotZooClientOutbound);
+        topics->emplace_back(getBaseTopic() + "/" + deviceName + "/0/frame",
+                             "Base64 of a binary frame: format (0: RGB, 1: palette, +128: run length encoded), first pixel, number of "
+                             "pixels, [palette], pixels",
+                             MessageDirection::IotZooClientOutbound);
+        topics->emplace_back(getBaseTopic() + "/" + deviceName + "/0/effect",
+                             R"({"effect": "blink", "index": 0, "length": 8, "color": "#FF0000", "color2": "#000000", "periodMs": 500, "durationMs": 10000})",
+                             MessageDirection::IotZooClientOutbound);
     }
 
     /// @brief The MQTT connection is established. Now subscribe to the topics. An existing MQTT connection is a prerequisite
@@ -309,6 +734,14 @@ namespace IotZoo
         topic = getBaseTopic() + "/" + deviceName + "/" + String(deviceIndex) + "/setPixelsByPreset";
         mqttClient->subscribe(topic, [&](const String& presetName) { setPixelsByPreset(presetName); });
         Serial.println("LED strip subscribed to topic " + topic);
+
+        topic = getBaseTopic() + "/" + deviceName + "/" + String(deviceIndex) + "/frame";
+        mqttClient->subscribe(topic, [&](const String& base64) { setPixelsByFrame(base64); });
+        Serial.println("LED strip subscribed to topic " + topic);
+
+        topic = getBaseTopic() + "/" + deviceName + "/" + String(deviceIndex) + "/effect";
+        mqttClient->subscribe(topic, [&](const String& json) { startEffect(json); });
+        Serial.println("LED strip subscribed to topic " + topic);
     }
 
     void WS2818::setPixelColorRgb(uint8_t r, uint8_t g, uint8_t b, uint16_t index, uint8_t brightness /* = 20*/, uint64_t millisUntilTurnOff /* = 0*/)
@@ -327,23 +760,39 @@ namespace IotZoo
 
     void WS2818::setPixelColor(uint32_t color, uint16_t index, uint8_t brightness /* = 20*/, uint64_t millisUntilTurnOff /* = 0*/)
     {
-        Serial.println("setPixelColor(color:" + String(color) + ", index: " + String(index) + ", brightness: " + String(brightness) +
-                       ", millisUntilTurnOff: " + String(millisUntilTurnOff) + ")");
-        if (index > this->numberOfLeds)
+        logDebug("setPixelColor(color:" << color << ", index: " << index << ", brightness: " << brightness
+                                        << ", millisUntilTurnOff: " << (unsigned long)millisUntilTurnOff << ")");
+        if (index >= this->numberOfLeds)
         {
             Serial.println("index out of range");
             return;
         }
-        if (brightness != 0 && pixels->getBrightness() != brightness)
+        if (brightness != 0)
         {
-            pixels->setBrightness(brightness); // affects all pixels!!!
+            pixelProperties[index].Brightness = brightness;
         }
-
-        pixels->setPixelColor(index, color);
+        colors[index] = color & 0xFFFFFF;
+        markDirty(index, index);
 
         if (millisUntilTurnOff > 0)
         {
             pixelProperties[index].MillisUntilTurnOff = millisUntilTurnOff + millis();
+            if (timeouts.size() >= 4 * numberOfLeds)
+            {
+                // too many stale entries, pixels were set again and again before they timed out
+                timeouts = {};
+                for (const auto& pixelProperty : pixelProperties)
+                {
+                    if (pixelProperty.MillisUntilTurnOff != 0)
+                    {
+                        timeouts.push({pixelProperty.MillisUntilTurnOff, (uint16_t)pixelProperty.PixelId});
+                    }
+                }
+            }
+            else
+            {
+                timeouts.push({pixelProperties[index].MillisUntilTurnOff, index});
+            }
         }
         else
         {
@@ -356,25 +356,26 @@ namespace IotZoo
     }
 
 #ifdef USE_INTERNAL_MQTT
-    static void onInternalReceivedData(const InternalMqttClient* /* srce */, const InternalTopic& topic, const char* payload, size_t /* length */)
+    static void onInternalReceivedData(const InternalMqttClient* /* srce */, const InternalTopic& topic, const char* payload, size_t length)
     {
         String strTopic = String(topic.c_str());
+        String message(payload, length); // payload is not null terminated
         if (strTopic.endsWith("/number"))
         {
-            TM1637_Handling::callbackMqttOnReceivedDataTm1637Number(topic.c_str(), String(payload));
+            TM1637_Handling::callbackMqttOnReceivedDataTm1637Number(topic.c_str(), message);
         }
         else if (strTopic.endsWith("/text"))
         {
-            debug("Received internal MQTT message for text: " + String(payload));
-            TM1637_Handling::callMqttbackOnReceivedDataTm1637Text(topic.c_str(), String(payload));
+            debug("Received internal MQTT message for text: " + message);
+            TM1637_Handling::callMqttbackOnReceivedDataTm1637Text(topic.c_str(), message);
         }
         else if (strTopic.endsWith("/level"))
         {
-            TM1637_Handling::callbackMqttOnReceivedDataTm1637Level(topic.c_str(), String(payload));
+            TM1637_Handling::callbackMqttOnReceivedDataTm1637Level(topic.c_str(), message);
         }
         else if (strTopic.endsWith("/temperature"))
         {
-            TM1637_Handling::callbackMqttOnReceivedDataTm1637Temperature(topic.c_str(), String(payload));
+            TM1637_Handling::callbackMqttOnReceivedDataTm1637Temperature(topic.c_str(), message);
         }
     }
 
@@ -11,9 +11,11 @@
 // --------------------------------------------------------------------------------------------------------------------
 // Includes
 // --------------------------------------------------------------------------------------------------------------------
+#include "BinaryLog.hpp"
 #include "ConnectionSettings.hpp"
 #include "DebugHelper.hpp"
 #include "Defines.hpp"
+#include "Scheduler.hpp"
 #include "pocos/Microcontroller.hpp"
 #include "pocos/Topic.hpp"
 #include "pocos/TopicLink.hpp"
@@ -21,6 +23,7 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <WiFi.h>
+#include <atomic>
 #include <list>
 
 #ifdef ERASE_FLASH
@@ -177,6 +180,17 @@ unsigned long lastServerAliveMillis = millis();
 long          loopCounter           = 0;
 long          loopDurationMs        = 0;
 
+Scheduler           scheduler;
+const unsigned long MaxIdleMs = 50; // upper limit of idling between two runs of the scheduler
+
+#ifdef USE_DUAL_CORE
+Scheduler        networkScheduler;              // MQTT client and REST server, runs in networkTaskLoop()
+const BaseType_t NetworkCore = 0;              // loop() runs on core 1
+std::atomic_bool connectionEstablished{false}; // set on the network core, handled on the device core
+#endif
+
+void registerSchedulerTasks(); // defined in front of loop()
+
 static const uint8_t LED_BUILTIN = 2;
 
 DayMode dayMode = DayMode::Unknown;
@@ -195,6 +209,10 @@ bool topicsRegistered = false;
 void restart()
 {
     debug("*** RESTART NOW!!! ***");
+    if (nullptr != settings)
+    {
+        settings->flush(); // do not lose changed settings
+    }
     ESP.restart();
 }
 
@@ -279,13 +297,51 @@ String getNamespaceAndProjectNameForTopic()
     return namespaceName + projectName;
 }
 
-/// @brief Get the base MQTT Topic.
-/// @return
-String getBaseTopic()
+String cachedBaseTopic; // empty: has to be built. Written by the device core only, see invalidateBaseTopic().
+
+#ifdef USE_DUAL_CORE
+std::atomic_bool baseTopicInvalidated{false}; // set by invalidateBaseTopic(), handled on the device core
+#endif
+
+String buildBaseTopic()
 {
     return getNamespaceAndProjectNameForTopic() + identifyBoard() + "/" + macAddress;
 }
 
+/// @brief Get the base MQTT Topic. It is built once, reading the names from the settings, and cached until invalidateBaseTopic().
+/// @return
+const String& getBaseTopic()
+{
+    if (cachedBaseTopic.length() == 0)
+    {
+        cachedBaseTopic = buildBaseTopic(); // in setup(), before the network task is started
+    }
+    return cachedBaseTopic;
+}
+
+/// @brief The namespace name, the project name or the MAC address have changed. With USE_DUAL_CORE it may be called on
+///        the network core (REST server), so it only sets a flag and the device core rebuilds the topic in
+///        rebuildInvalidatedBaseTopic().
+void invalidateBaseTopic()
+{
+#ifdef USE_DUAL_CORE
+    baseTopicInvalidated = true;
+#else
+    cachedBaseTopic = String();
+#endif
+}
+
+#ifdef USE_DUAL_CORE
+/// @brief Called by the device core. The topic is replaced in one assignment, it never becomes empty.
+void rebuildInvalidatedBaseTopic()
+{
+    if (baseTopicInvalidated.exchange(false))
+    {
+        cachedBaseTopic = buildBaseTopic();
+    }
+}
+#endif
+
 void publishError(const String& errMsg)
 {
     String topic = getBaseTopic() + "/error";
@@ -342,6 +398,7 @@ bool onReceivedMicrocontrollerConfiguration(const String& json)
         bool   ok0           = settings->setNamespaceName(namespaceName);
         bool   ok1           = settings->setProjectName(projectName);
         bool   ok2           = settings->setMqttBrokerIp(ipMqttBroker);
+        invalidateBaseTopic();
         if (ok0 && ok1 && ok2)
         {
             Serial.println("Successful saved settings");
@@ -420,6 +477,65 @@ void AddAliveNestedJsonObject(JsonDocument* jsonDocument)
     jsonObjectAlive["ReconnectionCount"]  = mqttClient->getConnectionEstablishedCount() - 1;
     jsonObjectAlive["AliveIntervalMs"]    = settings->getAliveIntervalMillis();
     jsonObjectAlive["AliveAckLedEnabled"] = settings->getAliveAckLedMode();
+
+    JsonObject jsonObjectPending   = jsonObjectAlive.createNestedObject("Pending"); // publishes waiting for the broker
+    jsonObjectPending["Depth"]     = mqttClient->getPendingCount();
+    jsonObjectPending["Dropped"]   = mqttClient->getPendingDropped();
+    jsonObjectPending["Coalesced"] = mqttClient->getPendingCoalesced();
+#ifdef USE_DUAL_CORE
+    const auto& outbound                  = mqttClient->getOutboundQueue();
+    const auto& inbound                   = mqttClient->getInboundQueue();
+    JsonObject  jsonObjectQueues          = jsonObjectAlive.createNestedObject("Queues");
+    jsonObjectQueues["OutboundDepth"]     = outbound.getDepth();
+    jsonObjectQueues["OutboundHighWater"] = outbound.getHighWater();
+    jsonObjectQueues["OutboundDropped"]   = outbound.getDropped();
+    jsonObjectQueues["InboundDepth"]      = inbound.getDepth();
+    jsonObjectQueues["InboundHighWater"]  = inbound.getHighWater();
+    jsonObjectQueues["InboundDropped"]    = inbound.getDropped();
+#endif
+}
+
+/// @brief Adds the histogram of the loop durations and the runtime of each task of a scheduler.
+void AddSchedulerJsonObject(JsonObject jsonObject, const Scheduler::Statistics& statistics)
+{
+    // Index n counts the loops of [2^(n-1), 2^n) µs, index 0 the loops of 0 µs.
+    JsonArray               jsonArrayHistogram = jsonObject.createNestedArray("LoopHistogram");
+    const LatencyHistogram& histogram          = statistics.runHistogram;
+    for (uint8_t bucket = 0; bucket < histogram.getUsedBucketCount(); bucket++)
+    {
+        jsonArrayHistogram.add(histogram.getCount(bucket));
+    }
+
+    JsonArray jsonArrayTasks = jsonObject.createNestedArray("Tasks");
+    for (const auto& task : statistics.tasks)
+    {
+        JsonObject jsonObjectTask = jsonArrayTasks.createNestedObject();
+        jsonObjectTask["Name"]    = task.name; // not copied, the task outlives the document
+        jsonObjectTask["Runs"]    = task.runs;
+        jsonObjectTask["TotalUs"] = task.totalMicros;
+        jsonObjectTask["MaxUs"]   = task.worstMicros;
+    }
+}
+
+/// @brief Adds where the loop spends its time.
+void AddMetricsNestedJsonObject(JsonDocument* jsonDocument)
+{
+    JsonObject jsonObjectMetrics = jsonDocument->createNestedObject("Metrics");
+    AddSchedulerJsonObject(jsonObjectMetrics.createNestedObject("Loop"), scheduler.getStatistics());
+#ifdef USE_DUAL_CORE
+    // runs on the other core, only its published copy is consistent
+    AddSchedulerJsonObject(jsonObjectMetrics.createNestedObject("Network"), networkScheduler.getPublishedStatistics());
+#endif
+#ifdef USE_INTERNAL_MQTT
+    // The topics of the internal broker, each distinct topic is stored once.
+    JsonObject                  jsonObjectStrings = jsonObjectMetrics.createNestedObject("InternedStrings");
+    const StringIndexer::Stats& stringStats       = StringIndexer::stats();
+    jsonObjectStrings["Count"]                    = StringIndexer::count();
+    jsonObjectStrings["MemoryUsed"]               = StringIndexer::memoryUsed();
+    jsonObjectStrings["Hits"]                     = stringStats.hits;
+    jsonObjectStrings["Misses"]                   = stringStats.misses;
+    jsonObjectStrings["OutOfCapacity"]            = stringStats.outOfCapacity;
+#endif
 }
 
 void AddSupportedDevicesNestedJsonObject(JsonDocument* jsonDocument)
@@ -650,6 +766,19 @@ String createAliveJson()
     serializeJson(jsonDocument, json);
     return json;
 }
+
+/// @brief Create Json for the metrics message.
+/// @return Json for metrics message
+String createMetricsJson()
+{
+    DynamicJsonDocument jsonDocument(4096); // on heap
+
+    AddMetricsNestedJsonObject(&jsonDocument);
+
+    String json;
+    serializeJson(jsonDocument["Metrics"], json);
+    return json;
+}
 #endif
 
 // ------------------------------------------------------------------------------------------------
@@ -664,7 +793,9 @@ void publishAliveMessage()
     aliveCounter++;
     String topicAlive = getBaseTopic() + "/alive";
     String json       = createAliveJson();
-    mqttClient->publish(topicAlive, json);
+    mqttClient->publishState(topicAlive, json);
+
+    mqttClient->publishState(getBaseTopic() + "/metrics", createMetricsJson());
 
     lastAliveTime = millis();
 }
@@ -747,7 +878,16 @@ void onLoadAndPublishConfigurationByKey(const String& key)
 // ------------------------------------------------------------------------------------------------
 
 #ifdef USE_MQTT
+#ifdef USE_DUAL_CORE
+void onConnectionEstablished() // do not rename! This method name is forced in EspMQTTClient.h. I do not like this.
+{
+    connectionEstablished = true; // called on the network core, handleConnectionEstablished() runs on the device core
+}
+
+void handleConnectionEstablished()
+#else
 void onConnectionEstablished() // do not rename! This method name is forced in EspMQTTClient.h. I do not like this.
+#endif
 {
     Serial.println("onMqttConnectionEstablished! baseTopic: " + getBaseTopic());
 
@@ -1036,10 +1176,13 @@ void makeInstanceConfiguredDevices()
                     targetTopic.toLowerCase();
 
                     String targetPayload = topicLinkVariant["TargetPayload"].as<String>();
+                    targetPayload.trim();
                     // Example: { "Operator": ">", "Value": "130"}
                     String expression = topicLinkVariant["Expression"].as<String>();
 
-                    topicLinks->emplace_back(triggeringTopic, expression, targetTopic, targetPayload);
+                    TopicLink& topicLink    = topicLinks->emplace_back(triggeringTopic, expression, targetTopic, targetPayload);
+                    topicLink.Deadband      = topicLinkVariant["Deadband"] | 0.0f;
+                    topicLink.MinIntervalMs = topicLinkVariant["MinIntervalMs"] | 0UL;
                 }
 #ifdef USE_BUTTON
                 if (deviceType == "Button")
@@ -1127,7 +1270,22 @@ void makeInstanceConfiguredDevices()
                     int pinRx = arrPins[0]["MicrocontrollerGpoPin"];
                     int pinTx = arrPins[1]["MicrocontrollerGpoPin"];
 
-                    gps = new Gps(deviceIndex, settings, mqttClient, getBaseTopic(), pinRx, pinTx);
+                    uint32_t      baud              = 9600;
+                    unsigned long publishIntervalMs = 1000;
+                    for (JsonVariant property : arrProperties)
+                    {
+                        String propertyName = property["Name"];
+                        if (propertyName == "Baud")
+                        {
+                            baud = property["Value"];
+                        }
+                        else if (propertyName == "PublishIntervalMs")
+                        {
+                            publishIntervalMs = property["Value"];
+                        }
+                    }
+
+                    gps = new Gps(deviceIndex, settings, mqttClient, getBaseTopic(), pinRx, pinTx, baud, publishIntervalMs);
                 }
 #endif // USE_GPS
 
@@ -1432,8 +1590,10 @@ void makeInstanceConfiguredDevices()
                 if (deviceType == "NEO")
                 {
                     Serial.println("Configuration of NEO pixels...");
-                    int dioPin       = arrPins[0]["MicrocontrollerGpoPin"];
-                    int numberOfLeds = 256;
+                    int  dioPin       = arrPins[0]["MicrocontrollerGpoPin"];
+                    int  numberOfLeds = 256;
+                    int  maxFps       = 0; // 0: default of WS2818
+                    bool gamma        = false;
 
                     for (JsonVariant property : arrProperties)
                     {
@@ -1443,8 +1603,21 @@ void makeInstanceConfiguredDevices()
                         {
                             numberOfLeds = std::stoi(propertyValue.c_str());
                         }
+                        else if (propertyName == "maxFps")
+                        {
+                            maxFps = std::stoi(propertyValue.c_str());
+                        }
+                        else if (propertyName == "gamma")
+                        {
+                            gamma = propertyValue == "true" || propertyValue == "1";
+                        }
                     }
                     ws2812 = new WS2818(deviceIndex, settings, mqttClient, getBaseTopic(), dioPin, numberOfLeds);
+                    if (maxFps > 0)
+                    {
+                        ws2812->setMaxFps(maxFps);
+                    }
+                    ws2812->setGammaCorrection(gamma);
                     Serial.println("Neo pixel configuration loaded! DIO Pin is " + String(dioPin) + ", Leds: " + String(numberOfLeds));
                 }
 #ifdef USE_WS2818_PIXEL_MATRIX
@@ -1455,6 +1628,8 @@ void makeInstanceConfiguredDevices()
                     uint numberOfLedsPerColumn = 8;
                     uint numberOfLedsPerRow    = 8;
                     uint extensions            = 0;
+                    int  maxFps                = 0; // 0: default of WS2818
+                    bool gamma                 = false;
 
                     for (JsonVariant property : arrProperties)
                     {
@@ -1472,10 +1647,23 @@ void makeInstanceConfiguredDevices()
                         {
                             extensions = std::stoi(propertyValue.c_str());
                         }
+                        else if (propertyName == "maxFps")
+                        {
+                            maxFps = std::stoi(propertyValue.c_str());
+                        }
+                        else if (propertyName == "gamma")
+                        {
+                            gamma = propertyValue == "true" || propertyValue == "1";
+                        }
                         extensions = 1;
                     }
                     ws2812 = new PixelMatrix(deviceIndex, settings, mqttClient, getBaseTopic(), dioPin, numberOfLedsPerColumn, numberOfLedsPerRow,
                                              (PixelMatrixExtensions)extensions);
+                    if (maxFps > 0)
+                    {
+                        ws2812->setMaxFps(maxFps);
+                    }
+                    ws2812->setGammaCorrection(gamma);
                     Serial.println("Neo pixel matrix configuration loaded! DIO Pin is " + String(dioPin) +
                                    ", numberOfLedsPerColumn: " + String(numberOfLedsPerColumn) +
                                    ", numberOfLedsPerRow: " + String(numberOfLedsPerRow) + ", Extensions: " + String(extensions));
@@ -1837,6 +2025,9 @@ void handlePostMicrocontrollerConfig()
     {
         debug("ProjectName not saved!");
     }
+#if defined(USE_MQTT)
+    invalidateBaseTopic();
+#endif
     // Respond to the client
     webServer.send(200, "application/json", "{}");
 
@@ -1875,21 +2066,7 @@ void notifyCallbackHeartRate(NimBLERemoteCharacteristic* pBLERemoteCharacteristi
 #ifdef USE_INTERNAL_MQTT
     {
         debug("Notify callback heart rate. data[1]: " + String(data[1]));
-        InternalMqttClient* internalMqttClient = heartRateSensor->getInternalMqttClient();
-        if (nullptr != internalMqttClient)
-        {
-            debug("Count of TopicLinks: " + String(heartRateSensor->getTopicLinks().size()));
-            // Has an internal component interest on counter changes?
-            for (auto& topicLink : heartRateSensor->getTopicLinks())
-            {
-                debug("topicLink.TriggeringTopic: " + topicLink.TriggeringTopic);
-                if (topicLink.TriggeringTopic.equalsIgnoreCase(getBaseTopic() + "/pulse/" + String(heartRateSensor->getDeviceIndex())))
-                {
-                    topicLink.Payload = String(data[1]).c_str();
-                    internalMqttClient->publish(topicLink);
-                }
-            }
-        }
+        heartRateSensor->signalValueChanged(getBaseTopic() + "/pulse/" + String(heartRateSensor->getDeviceIndex()), String(data[1]));
     }
 #endif // USE_INTERNAL_MQTT
 
@@ -1925,6 +2102,10 @@ void setup()
 
     macAddress = getMacAddress();
 
+#if defined(USE_BINARY_LOG) && !defined(BINARY_LOG_TO_MQTT)
+    binaryLog.beginSerialOutput();
+#endif
+
 #ifdef ERASE_FLASH
     // helps if the config is destroyed ...
     nvs_flash_erase(); // erase the NVS partition and...
@@ -2026,6 +2207,8 @@ void setup()
     }
 #endif
 #endif
+
+    registerSchedulerTasks();
 }
 
 #ifdef USE_MQTT
@@ -2063,6 +2246,13 @@ void registerTopics()
     // Alive message of the microcontroller
     topics.emplace_back(getBaseTopic() + "/alive", "Alive message of the microcontroller", MessageDirection::IotZooClientInbound);
 
+    // Loop duration histogram and runtime of each task, sent with the alive message
+    topics.emplace_back(getBaseTopic() + "/metrics", "Where the loop of the microcontroller spends its time", MessageDirection::IotZooClientInbound);
+
+#ifdef BINARY_LOG_TO_MQTT
+    topics.emplace_back(getBaseTopic() + "/log", "Binary log records, decode them with tools/decode_log.py", MessageDirection::IotZooClientInbound);
+#endif
+
     // How should the device send alive messages
     topics.emplace_back(getBaseTopic() + "/alive_config", "{\"aliveIntervalMs\": 15000, \"aliveAckLedMode\": 2}",
                         MessageDirection::IotZooClientInbound);
@@ -2296,237 +2486,331 @@ void onIotZooClientUnavailable()
 #endif
 }
 
+#if defined(USE_MQTT)
+void registerTopicsOnce()
+{
+    if (!topicsRegistered)
+    {
+        registerTopics();
+        String topic = getBaseTopic() + "/started";
+        mqttClient->publish(topic, "STARTED");
+    }
+}
+#endif
+
+#ifdef USE_DUAL_CORE
 // ------------------------------------------------------------------------------------------------
-// The loop.
+// The loop of the network core.
 // ------------------------------------------------------------------------------------------------
-void loop()
+void networkTaskLoop(void* /* parameter */)
 {
-    try
+#if defined(USE_MQTT)
+    mqttClient->setNetworkTask(xTaskGetCurrentTaskHandle());
+#endif
+    for (;;)
     {
-        if (WiFi.status() != WL_CONNECTED)
-        {
-            debug("🛜 🚫");
-        }
-        else
-        {
-            if (DebugHelper::debugLevel >= 3)
-            {
-                debug("🛜 ✅");
-            }
-        }
+        unsigned long idleMs = networkScheduler.run(MaxIdleMs);
+        networkScheduler.publishStatistics(); // for the metrics, which are created on the device core
+        vTaskDelay(pdMS_TO_TICKS(idleMs > 0 ? idleMs : 1)); // always yield, otherwise the watchdog of core 0 bites
+    }
+}
+#endif // USE_DUAL_CORE
+
+// ------------------------------------------------------------------------------------------------
+// The tasks of the loop.
+// ------------------------------------------------------------------------------------------------
+void registerSchedulerTasks()
+{
+#ifdef USE_DUAL_CORE
+    Scheduler& network = networkScheduler;
+#else
+    Scheduler& network = scheduler;
+#endif
 
 #ifdef USE_INTERNAL_MQTT
-        internalBroker->loop();
+    scheduler.addTask("InternalMqttBroker", 5,
+                      []()
+                      {
+                          if (WiFi.status() == WL_CONNECTED)
+                          {
+                              internalBroker->begin(); // listens once WiFi is up, no-op afterwards
+                          }
+                          internalBroker->loop();
+                      });
 #endif // USE_INTERNAL_MQTT
 
-        lastLoopStartTime = millis();
-
-        loopCounter++;
-
-        if (doRestart)
-        {
-            restart();
-        }
-
 #if defined(USE_MQTT)
-        mqttClient->loop();
+    network.addTask("MqttClient", 5,
+                    []()
+                    {
+                        unsigned long start = millis();
+                        mqttClient->loop();
 #ifndef USE_INTERNAL_MQTT
-        if (millis() - lastLoopStartTime > 10000)
-        {
-            Serial.print("BROKEN MQTT");
-            restart();
-        }
+                        if (millis() - start > 10000)
+                        {
+                            Serial.print("BROKEN MQTT");
+                            restart();
+                        }
+#endif
+                        if (!mqttClient->isConnected())
+                        {
+                            debug("⚠" << mqttClient->getConnectionEstablishedCount() << _EndLineCode::endl);
+                        }
+#ifndef USE_DUAL_CORE
+                        registerTopicsOnce();
+#endif
+                    });
+#ifdef USE_DUAL_CORE
+    scheduler.addTask("MqttReceived", 5,
+                      []()
+                      {
+                          rebuildInvalidatedBaseTopic();
+                          if (connectionEstablished.exchange(false))
+                          {
+                              handleConnectionEstablished();
+                          }
+                          mqttClient->dispatchReceivedMessages();
+                          registerTopicsOnce();
+                      });
 #endif
-        if (!mqttClient->isConnected())
-        {
-            debug("⚠" << mqttClient->getConnectionEstablishedCount() << _EndLineCode::endl);
-            // delay(200);
-        }
-
-        if (!topicsRegistered)
-        {
-            registerTopics();
-            String topic = getBaseTopic() + "/started";
-            mqttClient->publish(topic, "STARTED");
-        }
 #endif
 
 #ifdef USE_BLE_HEART_RATE_SENSOR
-        if (nullptr != heartRateSensor)
-        {
-            heartRateSensor->loop();
-        }
+    if (nullptr != heartRateSensor)
+    {
+        scheduler.addDevice("HeartRateSensor", heartRateSensor);
+    }
 #endif // USE_BLE_HEART_RATE_SENSOR
 
 #ifdef USE_BUTTON
-        buttonHandling.loop();
+    scheduler.addTask("Buttons", 5, []() { buttonHandling.loop(); });
 #endif
 
 #ifdef USE_ANALOG_INPUT_PIN
-        for (auto& analogInputPin : analogInputPins)
-        {
-            analogInputPin.loop();
-        }
+    for (auto& analogInputPin : analogInputPins)
+    {
+        scheduler.addDevice("AnalogInputPin", &analogInputPin);
+    }
 #endif // USE_ANALOG_INPUT_PIN
 
 #ifdef USE_KY025
-        if (nullptr != ky025)
-        {
-            ky025->loop();
-        }
+    if (nullptr != ky025)
+    {
+        scheduler.addDevice("KY025", ky025);
+    }
 #endif // USE_KY025
 
-        // {
-        //     TopicLink topicLink("", "iotzoo/picea/esp32/e4:65:b8:b0:45:b4/tm1637_4/0/number");
-        //     topicLink.Payload     = String(loopCounter).c_str();
-        //     InternalMqttError err = globalInternalMqttClient->publish(topicLink);
-        //     globalInternalMqttClient->loop();
-        // }
-
 #ifdef USE_AUDIO_STREAMER
-        if (nullptr != audioStreamer)
-        {
-            audioStreamer->loop();
-        }
+    if (nullptr != audioStreamer)
+    {
+        scheduler.addDevice("AudioStreamer", audioStreamer);
+    }
 #endif
 
 #ifdef USE_WS2818
-        if (nullptr != ws2812)
-        {
-            ws2812->loop();
-        }
+    if (nullptr != ws2812)
+    {
+        scheduler.addDevice("WS2818", ws2812);
+    }
 #endif
 
 #ifdef USE_HW507
-        if (nullptr != hw507HumiditySensor)
-        {
-            hw507HumiditySensor->loop();
-        }
+    if (nullptr != hw507HumiditySensor)
+    {
+        scheduler.addDevice("HW507", hw507HumiditySensor);
+    }
 #endif
 
 #ifdef USE_GPS
-        if (nullptr != gps)
-        {
-            gps->loop();
-        }
+    if (nullptr != gps)
+    {
+        scheduler.addDevice("Gps", gps);
+    }
 #endif
 
 #ifdef USE_SWITCH
-        for (auto& buttonSwitch : switches)
-        {
-            buttonSwitch.loop();
-        }
+    for (auto& buttonSwitch : switches)
+    {
+        scheduler.addDevice("Switch", &buttonSwitch);
+    }
 #endif
 
 #ifdef USE_LED_AND_KEY
-        if (nullptr != tm1638)
-        {
-            tm1638->loop();
-        }
+    if (nullptr != tm1638)
+    {
+        scheduler.addDevice("TM1638", tm1638);
+    }
 #endif // USE_LED_AND_KEY
 
 #ifdef USE_REST_SERVER
-        webServer.handleClient();
+    network.addTask("WebServer", 5, []() { webServer.handleClient(); });
 #endif
 
-        // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-        // The preconditions are fulfilled (MQTT connected).
-
 #ifdef USE_HW040
-        hw040Handling.loop();
+    scheduler.addTask("HW040", 5, []() { hw040Handling.loop(); });
 #endif
 
 #ifdef USE_STEPPER_MOTOR
-        if (nullptr != stepperMotor)
-        {
-            stepperMotor->loop();
-        }
+    if (nullptr != stepperMotor)
+    {
+        scheduler.addTask("StepperMotor", 5, []() { stepperMotor->loop(); });
+    }
 #endif
 
 #ifdef USE_DS18B20
-        if (nullptr != ds18B20SensorManager)
-        {
-            ds18B20SensorManager->loop();
-        }
+    if (nullptr != ds18B20SensorManager)
+    {
+        scheduler.addDevice("DS18B20", ds18B20SensorManager);
+    }
 #endif // USE_DS18B20
 
 #ifdef USE_HB0014
-        digitalValueInfrared = digitalRead(digitalPinInfraredLed);
+    scheduler.addTask("HB0014", 5,
+                      []()
+                      {
+                          digitalValueInfrared = digitalRead(digitalPinInfraredLed);
 
-        if (digitalValueInfrared == HIGH && digitalValueOldInfrared == LOW)
-        {
-            long diff = millis() - lastMillisInfrared;
+                          if (digitalValueInfrared == HIGH && digitalValueOldInfrared == LOW)
+                          {
+                              long diff = millis() - lastMillisInfrared;
 #ifdef USE_OLED_SSD1306
-            if (nullptr != oled1306)
-            {
-                oled1306->setTextLine(3, String(diff) + " ms");
-            }
+                              if (nullptr != oled1306)
+                              {
+                                  oled1306->setTextLine(3, String(diff) + " ms");
+                              }
 #endif
-            if (diff > 30)
-            {
-                // Umrechnen in Watt
+                              if (diff > 30)
+                              {
+                                  // Umrechnen in Watt
 
-                // 10000 Impulse entsprechen 1 KW/h.
+                                  // 10000 Impulse entsprechen 1 KW/h.
 
-                // Hochrechnen auf 10000 Impulse = 1000 Watt pro Stunde
-                double watt = 360000.0 / diff;
-                Serial.println(String(watt) + " watt");
+                                  // Hochrechnen auf 10000 Impulse = 1000 Watt pro Stunde
+                                  double watt = 360000.0 / diff;
+                                  Serial.println(String(watt) + " watt");
 #ifdef USE_OLED_SSD1306
-                if (nullptr != oled1306)
-                {
-                    oled1306->setTextLine(1, String(watt, 0));
-                }
+                                  if (nullptr != oled1306)
+                                  {
+                                      oled1306->setTextLine(1, String(watt, 0));
+                                  }
 #endif
-                String topic = getBaseTopic() + "/power/0";
-                mqttClient->publish(topic, String(watt, 0));
-                lastMillisInfrared = millis();
-            }
-        }
-        digitalValueOldInfrared = digitalValueInfrared;
+                                  String topic = getBaseTopic() + "/power/0";
+                                  mqttClient->publishState(topic, String(watt, 0));
+                                  lastMillisInfrared = millis();
+                              }
+                          }
+                          digitalValueOldInfrared = digitalValueInfrared;
+                      });
 #endif
 
 #ifdef USE_KEYPAD
-        buttonMatrixHandling.loop();
+    scheduler.addTask("ButtonMatrix", 5, []() { buttonMatrixHandling.loop(); });
 #endif
 
 #ifdef USE_HC_SR501
-        motionDetectorsHrsc501Handling.loop();
+    scheduler.addTask("HCSR501", 5, []() { motionDetectorsHrsc501Handling.loop(); });
 #endif
 
 #ifdef USE_RD_03D
-        if (nullptr != rd03d)
-        {
-            rd03d->loop();
-        }
+    if (nullptr != rd03d)
+    {
+        scheduler.addTask("Rd03D", 5, []() { rd03d->loop(); });
+    }
 #endif // USE_RD_03D
 
 #if defined(USE_MQTT)
-        try
+    scheduler.addTask("Alive",
+                      []() -> unsigned long
+                      {
+                          unsigned long intervalMs = settings->getAliveIntervalMillis();
+                          unsigned long elapsed    = millis() - lastAliveTime;
+                          if (elapsed <= intervalMs)
+                          {
+                              return intervalMs - elapsed + 1;
+                          }
+                          try
+                          {
+                              publishAliveMessage();
+                          }
+                          catch (const std::exception& e)
+                          {
+                              Serial.println(e.what()); // Exception handling does only work with build_flags -DPIO_FRAMEWORK_ARDUINO_ENABLE_EXCEPTIONS
+                          }
+                          return intervalMs;
+                      });
+#endif // USE_MQTT
+
+#ifdef BINARY_LOG_TO_MQTT
+    scheduler.addTask("BinaryLog", 1000,
+                      []()
+                      {
+                          if (!mqttClient->isConnected())
+                          {
+                              return; // the records wait in the ring buffer, binary publishes are not stored
+                          }
+                          static uint8_t buffer[1024];
+                          size_t         length = binaryLog.read(buffer, sizeof(buffer));
+                          if (length > 0)
+                          {
+                              mqttClient->publish(getBaseTopic() + "/log", buffer, length);
+                          }
+                      });
+#endif // BINARY_LOG_TO_MQTT
+
+    scheduler.addTask("Settings", 500, []() { settings->loop(); }); // writes changed settings to the flash
+
+    scheduler.addTask("ServerAlive", 1000,
+                      []()
+                      {
+                          if (millis() - lastServerAliveMillis > (settings->getAliveIntervalMillis() * 2))
+                          {
+                              onIotZooClientUnavailable();
+                              lastServerAliveMillis = millis();
+                          }
+                      });
+
+#ifdef USE_DUAL_CORE
+    xTaskCreatePinnedToCore(networkTaskLoop, "Network", 12288, nullptr, 1, nullptr, NetworkCore);
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+// The loop.
+// ------------------------------------------------------------------------------------------------
+void loop()
+{
+    try
+    {
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+        if (WiFi.status() != WL_CONNECTED)
         {
-            if (millis() - lastAliveTime > settings->getAliveIntervalMillis())
-            {
-                publishAliveMessage();
-            }
+            logDebug("🛜 🚫");
         }
-        catch (const std::exception& e)
+        else
         {
-            Serial.println(e.what()); // Exception handling does only work with build_flags -DPIO_FRAMEWORK_ARDUINO_ENABLE_EXCEPTIONS
+            logDebug("🛜 ✅");
         }
-#endif // USE_HC_SR501
+#endif
 
-        loopDurationMs = millis() - lastLoopStartTime;
+        lastLoopStartTime = millis();
+
+        loopCounter++;
 
-        if (millis() - lastServerAliveMillis > (settings->getAliveIntervalMillis() * 2))
+        if (doRestart)
         {
-            onIotZooClientUnavailable();
-            lastServerAliveMillis = millis();
+            restart();
         }
 
-        if (loopDurationMs < 5)
+        // Runs the tasks that are due, idles until the next one is.
+        unsigned long idleMs = scheduler.run(MaxIdleMs);
+
+        loopDurationMs = millis() - lastLoopStartTime;
+
+        digitalWrite(LED_BUILTIN, LOW); // turn the LED off to indicate that the device is offline.
+        if (idleMs > 0)
         {
-            delay(5 - loopDurationMs);
+            delay(idleMs);
         }
-        digitalWrite(LED_BUILTIN, LOW); // turn the LED off to indicate that the device is offline.
     }
     catch (const std::exception& e)
     {
@@ -0,0 +1,80 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Host fake of Adafruit_NeoPixel for the native tests. show() only counts, the encoded pixels can be read back.
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "Arduino.h"
+
+#include <vector>
+
+#define NEO_GRB ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_KHZ800 0x0000
+
+class Adafruit_NeoPixel
+{
+  public:
+    Adafruit_NeoPixel(uint16_t n, int16_t pin = 6, uint16_t type = NEO_GRB + NEO_KHZ800) : bytes(n * 3, 0)
+    {
+    }
+
+    void begin()
+    {
+    }
+
+    void clear()
+    {
+        std::fill(bytes.begin(), bytes.end(), 0);
+    }
+
+    void show()
+    {
+        showCount++;
+    }
+
+    bool canShow() const
+    {
+        return true;
+    }
+
+    uint16_t numPixels() const
+    {
+        return bytes.size() / 3;
+    }
+
+    void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b)
+    {
+        if (n < numPixels())
+        {
+            bytes[n * 3]     = g; // NEO_GRB
+            bytes[n * 3 + 1] = r;
+            bytes[n * 3 + 2] = b;
+        }
+    }
+
+    void setPixelColor(uint16_t n, uint32_t c)
+    {
+        setPixelColor(n, c >> 16, c >> 8, c);
+    }
+
+    uint8_t* getPixels()
+    {
+        return bytes.data();
+    }
+
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b)
+    {
+        return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    }
+
+    unsigned showCount = 0; // test side
+
+  protected:
+    std::vector<uint8_t> bytes;
+};
@@ -0,0 +1,208 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Host fake of the Arduino core for the native tests, only what the tested sources use.
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "WString.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+typedef bool         boolean;
+typedef uint8_t      u8_t;
+typedef uint16_t     u16_t;
+typedef uint32_t     u32_t;
+typedef uint8_t      u_int8_t;
+typedef uint16_t     u_int16_t;
+typedef uint32_t     u_int32_t;
+typedef unsigned int uint;
+
+#define IRAM_ATTR
+#define F(text) text
+#define DEC 10
+#define HEX 16
+#define SERIAL_8N1 0x800001c
+#define PI 3.1415926535897932384626433832795
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+#define radians(deg) ((deg) * DEG_TO_RAD)
+#define degrees(rad) ((rad) * RAD_TO_DEG)
+#define sq(x) ((x) * (x))
+
+namespace Fake
+{
+    inline const auto            startTime    = std::chrono::steady_clock::now();
+    inline unsigned long         millisOffset = 0; // added to millis() and micros() by advanceMillis()
+
+    /// @brief Lets the time pass without waiting, e.g. for timeouts.
+    inline void advanceMillis(unsigned long ms)
+    {
+        millisOffset += ms;
+    }
+} // namespace Fake
+
+inline unsigned long micros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - Fake::startTime).count() +
+           Fake::millisOffset * 1000;
+}
+
+inline unsigned long millis()
+{
+    return micros() / 1000;
+}
+
+inline void delay(unsigned long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+inline void yield()
+{
+}
+
+/// @brief Spinlock of FreeRTOS on the ESP32, a mutex here, so that the thread sanitizer sees the critical sections.
+struct portMUX_TYPE
+{
+    std::mutex mutex;
+};
+
+#define portMUX_INITIALIZER_UNLOCKED {}
+
+inline void portENTER_CRITICAL(portMUX_TYPE* lock)
+{
+    lock->mutex.lock();
+}
+
+inline void portEXIT_CRITICAL(portMUX_TYPE* lock)
+{
+    lock->mutex.unlock();
+}
+
+/// @brief UART. Output is dropped, input is what a test has injected with receive().
+class HardwareSerial
+{
+  public:
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1)
+    {
+    }
+
+    void end()
+    {
+    }
+
+    void setRxBufferSize(size_t size)
+    {
+    }
+
+    void onReceive(std::function<void()> callback, bool onlyOnTimeout = false)
+    {
+        receiveCallback = callback;
+    }
+
+    template <class T> size_t print(const T&)
+    {
+        return 0;
+    }
+
+    template <class T> size_t print(const T&, int)
+    {
+        return 0;
+    }
+
+    template <class T> size_t println(const T&)
+    {
+        return 0;
+    }
+
+    template <class T> size_t println(const T&, int)
+    {
+        return 0;
+    }
+
+    size_t println()
+    {
+        return 0;
+    }
+
+    size_t write(const uint8_t* data, size_t length)
+    {
+        return length;
+    }
+
+    int available()
+    {
+        return rx.size() - rxOffset;
+    }
+
+    int read()
+    {
+        uint8_t byte;
+        return read(&byte, 1) == 1 ? byte : -1;
+    }
+
+    size_t read(uint8_t* buffer, size_t size)
+    {
+        size_t length = std::min<size_t>(size, available());
+        memcpy(buffer, rx.data() + rxOffset, length);
+        rxOffset += length;
+        return length;
+    }
+
+    /// @brief Test side: data arrives, the callback set by onReceive() is called like by the uart event task.
+    void receive(const std::string& data)
+    {
+        rx.erase(0, rxOffset);
+        rxOffset = 0;
+        rx += data;
+        if (receiveCallback)
+        {
+            receiveCallback();
+        }
+    }
+
+  protected:
+    std::function<void()> receiveCallback;
+    std::string           rx;
+    size_t                rxOffset = 0;
+};
+
+inline HardwareSerial Serial;
+inline HardwareSerial Serial1;
+inline HardwareSerial Serial2;
+
+class EspClass
+{
+  public:
+    uint32_t getFreeHeap()
+    {
+        return 0;
+    }
+
+    uint32_t getMinFreeHeap()
+    {
+        return 0;
+    }
+
+    void restart()
+    {
+    }
+};
+
+inline EspClass ESP;
@@ -0,0 +1,193 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Scripted host fake of AsyncTCP for the native tests. Nothing runs in the background: a test connects to the
+// AsyncServer, lets the AsyncClient receive data, reads what was sent and closes it. The callbacks are called at once.
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "lwip/pbuf.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+class AsyncClient;
+
+typedef std::function<void(void*, AsyncClient*)>                   AcConnectHandler;
+typedef std::function<void(void*, AsyncClient*, size_t, uint32_t)> AcAckHandler;
+typedef std::function<void(void*, AsyncClient*, void*, size_t)>    AcDataHandler;
+typedef std::function<void(void*, AsyncClient*, struct pbuf*)>     AcPacketHandler;
+
+class AsyncClient
+{
+  public:
+    static inline int instances = 0; // not yet deleted
+
+    AsyncClient()
+    {
+        instances++;
+    }
+
+    ~AsyncClient()
+    {
+        instances--;
+    }
+
+    void onData(AcDataHandler callback, void* arg = nullptr)
+    {
+        dataCallback = callback;
+        dataArg      = arg;
+    }
+
+    void onPacket(AcPacketHandler callback, void* arg = nullptr)
+    {
+        packetCallback = callback;
+        packetArg      = arg;
+    }
+
+    void onAck(AcAckHandler callback, void* arg = nullptr)
+    {
+        ackCallback = callback;
+        ackArg      = arg;
+    }
+
+    void onDisconnect(AcConnectHandler callback, void* arg = nullptr)
+    {
+        disconnectCallback = callback;
+        disconnectArg      = arg;
+    }
+
+    void setNoDelay(bool)
+    {
+    }
+
+    void ackPacket(struct pbuf* packet)
+    {
+        pbuf_free(packet);
+    }
+
+    size_t space() const
+    {
+        return isConnected ? 65535 : 0; // the peer reads at once, so onAck is never needed
+    }
+
+    size_t add(const char* data, size_t size, uint8_t flags = 0)
+    {
+        sent.append(data, size);
+        return size;
+    }
+
+    bool send()
+    {
+        return isConnected;
+    }
+
+    bool connected() const
+    {
+        return isConnected;
+    }
+
+    /// @brief Calls the disconnect callback, which may delete this client.
+    void close(bool now = false)
+    {
+        if (isConnected)
+        {
+            isConnected = false;
+            if (disconnectCallback)
+            {
+                disconnectCallback(disconnectArg, this);
+            }
+        }
+    }
+
+    /// @brief Test side: the peer has sent data, it arrives as one packet.
+    void receive(const std::string& data)
+    {
+        if (packetCallback)
+        {
+            packetCallback(packetArg, this, Fake::pbuf_alloc(data.data(), data.size()));
+        }
+        else if (dataCallback)
+        {
+            dataCallback(dataArg, this, const_cast<char*>(data.data()), data.size());
+        }
+    }
+
+    /// @brief Test side: takes what was sent to the peer.
+    std::string takeSent()
+    {
+        std::string data;
+        data.swap(sent);
+        return data;
+    }
+
+  protected:
+    bool             isConnected = true;
+    std::string      sent;
+    AcDataHandler    dataCallback;
+    void*            dataArg = nullptr;
+    AcPacketHandler  packetCallback;
+    void*            packetArg = nullptr;
+    AcAckHandler     ackCallback;
+    void*            ackArg = nullptr;
+    AcConnectHandler disconnectCallback;
+    void*            disconnectArg = nullptr;
+};
+
+class AsyncServer
+{
+  public:
+    static inline AsyncServer* listening = nullptr; // the server after begin()
+
+    explicit AsyncServer(uint16_t port) : port(port)
+    {
+    }
+
+    ~AsyncServer()
+    {
+        end();
+    }
+
+    void onClient(AcConnectHandler callback, void* arg)
+    {
+        clientCallback = callback;
+        clientArg      = arg;
+    }
+
+    void setNoDelay(bool)
+    {
+    }
+
+    void begin()
+    {
+        listening = this;
+    }
+
+    void end()
+    {
+        if (listening == this)
+        {
+            listening = nullptr;
+        }
+    }
+
+    /// @brief Test side: a peer connects.
+    AsyncClient* accept()
+    {
+        AsyncClient* client = new AsyncClient();
+        clientCallback(clientArg, client);
+        return client;
+    }
+
+  protected:
+    uint16_t         port;
+    AcConnectHandler clientCallback;
+    void*            clientArg = nullptr;
+};
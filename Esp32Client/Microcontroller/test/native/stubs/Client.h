@@ -0,0 +1,70 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Host fake of the Arduino Client interface for the native tests.
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "Arduino.h"
+
+class IPAddress
+{
+  public:
+    String toString() const
+    {
+        return "0.0.0.0";
+    }
+};
+
+class Print
+{
+  public:
+    virtual ~Print()
+    {
+    }
+
+    virtual size_t write(uint8_t) = 0;
+
+    virtual size_t write(const uint8_t* buffer, size_t size) = 0;
+
+    size_t write(const char* buffer, size_t size)
+    {
+        return write(reinterpret_cast<const uint8_t*>(buffer), size);
+    }
+};
+
+class Stream : public Print
+{
+  public:
+    virtual int available() = 0;
+
+    virtual int read() = 0;
+
+    virtual int peek() = 0;
+
+    virtual void flush() = 0;
+};
+
+class Client : public Stream
+{
+  public:
+    virtual int connect(IPAddress ip, uint16_t port) = 0;
+
+    virtual int connect(const char* host, uint16_t port) = 0;
+
+    virtual int read(uint8_t* buffer, size_t size) = 0;
+
+    virtual void stop() = 0;
+
+    virtual uint8_t connected() = 0;
+
+    virtual operator bool() = 0;
+
+    using Print::write;
+    using Stream::read;
+};
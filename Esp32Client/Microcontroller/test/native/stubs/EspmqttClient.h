@@ -0,0 +1,142 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Host fake of EspMQTTClient for the native tests. A test sets the connection state and reads the publishes.
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "Arduino.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+typedef std::function<void(const String& message)>                     MessageReceivedCallback;
+typedef std::function<void(const String& topicStr, const String& message)> MessageReceivedCallbackWithTopic;
+
+class EspMQTTClient
+{
+  public:
+    struct Publish
+    {
+        String topic;
+        String payload;
+        bool   retain;
+    };
+
+    EspMQTTClient(const char* wifiSsid, const char* wifiPassword, const char* mqttServerIp, const char* mqttUsername,
+                  const char* mqttPassword, const char* mqttClientName, const short mqttServerPort = 1883)
+    {
+    }
+
+    bool setMaxPacketSize(const uint16_t size)
+    {
+        return true;
+    }
+
+    void enableDebuggingMessages(const bool enabled = true)
+    {
+    }
+
+    void setMqttReconnectionAttemptDelay(const unsigned int milliseconds)
+    {
+    }
+
+    void setKeepAlive(uint16_t keepAliveSeconds)
+    {
+    }
+
+    void enableOTA(const char* password = nullptr, const uint16_t port = 0)
+    {
+    }
+
+    void enableLastWillMessage(const char* topic, const char* message, const bool retain = false)
+    {
+    }
+
+    bool publish(const String& topic, const String& payload, bool retain = false)
+    {
+        if (!connected)
+        {
+            return false;
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        published.push_back({topic, payload, retain});
+        return true;
+    }
+
+    bool publish(const char* topic, const uint8_t* payload, unsigned int payloadLength, bool retain = false)
+    {
+        return publish(String(topic), String(payload, payloadLength), retain);
+    }
+
+    bool subscribe(const String& topic, MessageReceivedCallback messageReceivedCallback, uint8_t qos = 0)
+    {
+        return connected;
+    }
+
+    bool subscribe(const String& topic, MessageReceivedCallbackWithTopic messageReceivedCallback, uint8_t qos = 0)
+    {
+        return connected;
+    }
+
+    bool unsubscribe(const String& topic)
+    {
+        return connected;
+    }
+
+    void loop()
+    {
+    }
+
+    bool isConnected() const
+    {
+        return connected;
+    }
+
+    bool isWifiConnected() const
+    {
+        return connected;
+    }
+
+    bool isMqttConnected() const
+    {
+        return connected;
+    }
+
+    unsigned int getConnectionEstablishedCount() const
+    {
+        return 1;
+    }
+
+    const char* getMqttServerIp() const
+    {
+        return "127.0.0.1";
+    }
+
+    /// @brief Test side: the broker is reachable or not.
+    void setConnected(bool connected)
+    {
+        this->connected = connected;
+    }
+
+    /// @brief Test side: takes the messages published so far.
+    std::vector<Publish> takePublished()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        std::vector<Publish>        result;
+        result.swap(published);
+        return result;
+    }
+
+  protected:
+    std::atomic_bool     connected{true};
+    std::mutex           lock;
+    std::vector<Publish> published;
+};
@@ -0,0 +1,177 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Host fake of the ESP32 Preferences (NVS) for the native tests. The namespaces are kept in memory and the
+// operations are counted, so a test can check how often the flash would be read and written.
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "Arduino.h"
+
+#include <map>
+#include <string>
+
+namespace Fake
+{
+    struct Nvs
+    {
+        static inline std::map<std::string, std::map<std::string, std::string>> namespaces;
+        static inline unsigned                                                  begins = 0;
+        static inline unsigned                                                  reads  = 0;
+        static inline unsigned                                                  writes = 0;
+
+        static void clear()
+        {
+            namespaces.clear();
+            begins = 0;
+            reads  = 0;
+            writes = 0;
+        }
+    };
+} // namespace Fake
+
+class Preferences
+{
+  public:
+    bool begin(const char* name, bool readOnly = false, const char* partitionLabel = nullptr)
+    {
+        Fake::Nvs::begins++;
+        values = &Fake::Nvs::namespaces[name];
+        return true;
+    }
+
+    void end()
+    {
+        values = nullptr;
+    }
+
+    bool clear()
+    {
+        Fake::Nvs::writes++;
+        values->clear();
+        return true;
+    }
+
+    bool remove(const char* key)
+    {
+        Fake::Nvs::writes++;
+        return values->erase(key) > 0;
+    }
+
+    bool isKey(const char* key)
+    {
+        return values->count(key) > 0;
+    }
+
+    size_t putString(const char* key, const String& value)
+    {
+        return put(key, value.c_str(), value.length());
+    }
+
+    size_t putString(const char* key, const char* value)
+    {
+        return put(key, value, strlen(value));
+    }
+
+    String getString(const char* key, const String& defaultValue = String())
+    {
+        const std::string* value = get(key);
+        return value ? String(value->c_str()) : defaultValue;
+    }
+
+    size_t putBool(const char* key, bool value)
+    {
+        return put(key, std::to_string(value), sizeof(uint8_t));
+    }
+
+    bool getBool(const char* key, bool defaultValue = false)
+    {
+        const std::string* value = get(key);
+        return value ? atoi(value->c_str()) != 0 : defaultValue;
+    }
+
+    size_t putInt(const char* key, int32_t value)
+    {
+        return put(key, std::to_string(value), sizeof(int32_t));
+    }
+
+    int32_t getInt(const char* key, int32_t defaultValue = 0)
+    {
+        const std::string* value = get(key);
+        return value ? atol(value->c_str()) : defaultValue;
+    }
+
+    size_t putUInt(const char* key, uint32_t value)
+    {
+        return put(key, std::to_string(value), sizeof(uint32_t));
+    }
+
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0)
+    {
+        const std::string* value = get(key);
+        return value ? strtoul(value->c_str(), nullptr, 10) : defaultValue;
+    }
+
+    size_t putLong(const char* key, int32_t value)
+    {
+        return putInt(key, value);
+    }
+
+    int32_t getLong(const char* key, int32_t defaultValue = 0)
+    {
+        return getInt(key, defaultValue);
+    }
+
+    size_t putULong(const char* key, uint32_t value)
+    {
+        return putUInt(key, value);
+    }
+
+    uint32_t getULong(const char* key, uint32_t defaultValue = 0)
+    {
+        return getUInt(key, defaultValue);
+    }
+
+    size_t putUShort(const char* key, uint16_t value)
+    {
+        return put(key, std::to_string(value), sizeof(uint16_t));
+    }
+
+    uint16_t getUShort(const char* key, uint16_t defaultValue = 0)
+    {
+        return getUInt(key, defaultValue);
+    }
+
+    size_t putUChar(const char* key, uint8_t value)
+    {
+        return put(key, std::to_string(value), sizeof(uint8_t));
+    }
+
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0)
+    {
+        return getUInt(key, defaultValue);
+    }
+
+  protected:
+    std::map<std::string, std::string>* values = nullptr;
+
+    // Returns the bytes written like the real one: size, the length of a string or of the number type.
+    size_t put(const char* key, const std::string& value, size_t size)
+    {
+        Fake::Nvs::writes++;
+        (*values)[key] = value;
+        return size;
+    }
+
+    const std::string* get(const char* key)
+    {
+        Fake::Nvs::reads++;
+        auto it = values->find(key);
+        return it == values->end() ? nullptr : &it->second;
+    }
+};
@@ -0,0 +1,44 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Host fake of TinyConsole for the native tests: the log output is dropped.
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "Arduino.h"
+
+#include <string>
+
+namespace TinyConsole
+{
+    using string = std::string;
+
+    enum Color
+    {
+        green,
+        red,
+        white,
+        erase_to_end
+    };
+} // namespace TinyConsole
+
+enum _EndLineCode
+{
+    endl
+};
+
+class ConsoleT
+{
+  public:
+    template <class T> ConsoleT& operator<<(const T&)
+    {
+        return *this;
+    }
+};
+
+inline ConsoleT Console;
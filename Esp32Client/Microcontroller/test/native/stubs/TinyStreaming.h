@@ -0,0 +1,18 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Host fake of TinyStreaming for the native tests.
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "TinyConsole.h"
+
+template <class T> T _HEX(T value)
+{
+    return value;
+}
@@ -0,0 +1,375 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Host fake of the Arduino String on top of std::string for the native tests.
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+#include <string>
+#include <type_traits>
+
+class String
+{
+  public:
+    String()
+    {
+    }
+
+    String(const char* text) : s(text ? text : "")
+    {
+    }
+
+    String(const char* text, unsigned length) : s(text, length)
+    {
+    }
+
+    String(const uint8_t* text, unsigned length) : s(reinterpret_cast<const char*>(text), length)
+    {
+    }
+
+    explicit String(char c) : s(1, c)
+    {
+    }
+
+    explicit String(int value, unsigned char base = 10) : s(format(value, base))
+    {
+    }
+
+    explicit String(unsigned value, unsigned char base = 10) : s(format(value, base))
+    {
+    }
+
+    explicit String(long value, unsigned char base = 10) : s(format(value, base))
+    {
+    }
+
+    explicit String(unsigned long value, unsigned char base = 10) : s(format(value, base))
+    {
+    }
+
+    explicit String(long long value, unsigned char base = 10) : s(format(value, base))
+    {
+    }
+
+    explicit String(unsigned long long value, unsigned char base = 10) : s(format(value, base))
+    {
+    }
+
+    explicit String(double value, unsigned int decimalPlaces = 2)
+    {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%.*f", decimalPlaces, value);
+        s = buffer;
+    }
+
+    explicit String(float value, unsigned int decimalPlaces = 2) : String(static_cast<double>(value), decimalPlaces)
+    {
+    }
+
+    // Arduino assigns a number in decimal, through the implicit constructors of StringSumHelper.
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, char>>>
+    String& operator=(T value)
+    {
+        s = String(value).s;
+        return *this;
+    }
+
+    String(const String&)            = default;
+    String(String&&)                 = default;
+    String& operator=(const String&) = default;
+    String& operator=(String&&)      = default;
+
+    const char* c_str() const
+    {
+        return s.c_str();
+    }
+
+    unsigned length() const
+    {
+        return s.size();
+    }
+
+    bool isEmpty() const
+    {
+        return s.empty();
+    }
+
+    bool reserve(unsigned size)
+    {
+        s.reserve(size);
+        return true;
+    }
+
+    void clear()
+    {
+        s.clear();
+    }
+
+    bool concat(const String& other)
+    {
+        s += other.s;
+        return true;
+    }
+
+    bool concat(const char* text)
+    {
+        s += text;
+        return true;
+    }
+
+    bool concat(const char* text, unsigned length)
+    {
+        s.append(text, length);
+        return true;
+    }
+
+    bool concat(char c)
+    {
+        s += c;
+        return true;
+    }
+
+    String& operator+=(const String& other)
+    {
+        s += other.s;
+        return *this;
+    }
+
+    String& operator+=(const char* text)
+    {
+        s += text;
+        return *this;
+    }
+
+    String& operator+=(char c)
+    {
+        s += c;
+        return *this;
+    }
+
+    bool operator==(const String& other) const
+    {
+        return s == other.s;
+    }
+
+    bool operator==(const char* text) const
+    {
+        return s == text;
+    }
+
+    bool operator!=(const String& other) const
+    {
+        return s != other.s;
+    }
+
+    bool operator<(const String& other) const
+    {
+        return s < other.s;
+    }
+
+    char operator[](unsigned index) const
+    {
+        return s[index];
+    }
+
+    char& operator[](unsigned index)
+    {
+        return s[index];
+    }
+
+    char charAt(unsigned index) const
+    {
+        return s[index];
+    }
+
+    bool equals(const String& other) const
+    {
+        return s == other.s;
+    }
+
+    bool equalsIgnoreCase(const String& other) const
+    {
+        return strcasecmp(s.c_str(), other.c_str()) == 0;
+    }
+
+    int compareTo(const String& other) const
+    {
+        return s.compare(other.s);
+    }
+
+    bool startsWith(const String& prefix) const
+    {
+        return s.rfind(prefix.s, 0) == 0;
+    }
+
+    bool endsWith(const String& suffix) const
+    {
+        return s.size() >= suffix.s.size() && s.compare(s.size() - suffix.s.size(), suffix.s.size(), suffix.s) == 0;
+    }
+
+    int indexOf(char c, unsigned from = 0) const
+    {
+        return position(s.find(c, from));
+    }
+
+    int indexOf(const String& text, unsigned from = 0) const
+    {
+        return position(s.find(text.s, from));
+    }
+
+    int lastIndexOf(char c) const
+    {
+        return position(s.rfind(c));
+    }
+
+    int lastIndexOf(const String& text) const
+    {
+        return position(s.rfind(text.s));
+    }
+
+    String substring(unsigned from) const
+    {
+        return from < s.size() ? String(s.data() + from, s.size() - from) : String();
+    }
+
+    String substring(unsigned from, unsigned to) const
+    {
+        return from < s.size() && from < to ? String(s.data() + from, std::min<size_t>(to, s.size()) - from) : String();
+    }
+
+    void remove(unsigned index)
+    {
+        s.erase(index);
+    }
+
+    void remove(unsigned index, unsigned count)
+    {
+        s.erase(index, count);
+    }
+
+    void replace(const String& find, const String& replacement)
+    {
+        for (size_t pos = 0; find.s.size() && (pos = s.find(find.s, pos)) != std::string::npos; pos += replacement.s.size())
+        {
+            s.replace(pos, find.s.size(), replacement.s);
+        }
+    }
+
+    void trim()
+    {
+        size_t first = s.find_first_not_of(" \t\r\n");
+        size_t last  = s.find_last_not_of(" \t\r\n");
+        s            = first == std::string::npos ? std::string() : s.substr(first, last - first + 1);
+    }
+
+    void toLowerCase()
+    {
+        for (auto& c : s)
+        {
+            c = tolower(c);
+        }
+    }
+
+    void toUpperCase()
+    {
+        for (auto& c : s)
+        {
+            c = toupper(c);
+        }
+    }
+
+    long toInt() const
+    {
+        return atol(s.c_str());
+    }
+
+    float toFloat() const
+    {
+        return atof(s.c_str());
+    }
+
+    double toDouble() const
+    {
+        return atof(s.c_str());
+    }
+
+  protected:
+    std::string s;
+
+    static int position(size_t pos)
+    {
+        return pos == std::string::npos ? -1 : static_cast<int>(pos);
+    }
+
+    template <class T> static std::string format(T value, unsigned char base)
+    {
+        if (base == 10)
+        {
+            return std::to_string(value);
+        }
+        std::string digits;
+        auto        rest = static_cast<unsigned long long>(value);
+        do
+        {
+            digits.insert(digits.begin(), "0123456789abcdefghijklmnopqrstuvwxyz"[rest % base]);
+            rest /= base;
+        } while (rest);
+        return digits;
+    }
+};
+
+/// @brief Result of operator+, ArduinoJson knows it as a String.
+class StringSumHelper : public String
+{
+  public:
+    StringSumHelper(const String& s) : String(s)
+    {
+    }
+};
+
+inline StringSumHelper operator+(const String& left, const String& right)
+{
+    String sum(left);
+    sum += right;
+    return sum;
+}
+
+inline StringSumHelper operator+(const String& left, const char* right)
+{
+    String sum(left);
+    sum += right;
+    return sum;
+}
+
+inline StringSumHelper operator+(const char* left, const String& right)
+{
+    String sum(left);
+    sum += right;
+    return sum;
+}
+
+inline StringSumHelper operator+(const String& left, char right)
+{
+    String sum(left);
+    sum += right;
+    return sum;
+}
+
+template <class Number, class = typename std::enable_if<std::is_arithmetic<Number>::value>::type>
+inline StringSumHelper operator+(const String& left, Number right)
+{
+    String sum(left);
+    sum += String(right);
+    return sum;
+}
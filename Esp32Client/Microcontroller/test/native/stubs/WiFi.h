@@ -0,0 +1,101 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Host fake of the ESP32 WiFi for the native tests: there is no network, connecting always fails.
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "Arduino.h"
+#include "Client.h"
+
+#define WL_CONNECTED 3
+
+class WiFiClient : public Client
+{
+  public:
+    int connect(IPAddress ip, uint16_t port) override
+    {
+        return 0;
+    }
+
+    int connect(const char* host, uint16_t port) override
+    {
+        return 0;
+    }
+
+    uint8_t connected() override
+    {
+        return 0;
+    }
+
+    int available() override
+    {
+        return 0;
+    }
+
+    int read() override
+    {
+        return -1;
+    }
+
+    int read(uint8_t* buffer, size_t size) override
+    {
+        return 0;
+    }
+
+    int peek() override
+    {
+        return -1;
+    }
+
+    void flush() override
+    {
+    }
+
+    size_t write(uint8_t) override
+    {
+        return 0;
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override
+    {
+        return 0;
+    }
+
+    void stop() override
+    {
+    }
+
+    operator bool() override
+    {
+        return false;
+    }
+
+    using Print::write;
+};
+
+class WiFiClass
+{
+  public:
+    String macAddress()
+    {
+        return "00:00:00:00:00:00";
+    }
+
+    IPAddress localIP()
+    {
+        return IPAddress();
+    }
+
+    int status()
+    {
+        return 0;
+    }
+};
+
+inline WiFiClass WiFi;
@@ -0,0 +1,47 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Host fake of the lwIP packet buffer for the native tests. Buffers still allocated are counted.
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+struct pbuf
+{
+    struct pbuf* next;
+    void*        payload;
+    uint16_t     tot_len;
+    uint16_t     len;
+};
+
+namespace Fake
+{
+    inline int pbufsAllocated = 0;
+
+    inline pbuf* pbuf_alloc(const void* data, uint16_t length)
+    {
+        pbuf* packet    = static_cast<pbuf*>(malloc(sizeof(pbuf) + length));
+        packet->next    = nullptr;
+        packet->payload = packet + 1;
+        packet->tot_len = length;
+        packet->len     = length;
+        memcpy(packet->payload, data, length);
+        pbufsAllocated++;
+        return packet;
+    }
+} // namespace Fake
+
+inline uint8_t pbuf_free(struct pbuf* packet)
+{
+    Fake::pbufsAllocated--;
+    free(packet);
+    return 1;
+}
@@ -0,0 +1,66 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Host replacement of the mbedTLS Base64 decoder for the native tests, same interface and error codes.
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#define MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL -0x002A
+#define MBEDTLS_ERR_BASE64_INVALID_CHARACTER -0x002C
+
+inline int mbedtls_base64_decode(unsigned char* dst, size_t dlen, size_t* olen, const unsigned char* src, size_t slen)
+{
+    static const char* Alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    if (slen % 4 != 0)
+    {
+        return MBEDTLS_ERR_BASE64_INVALID_CHARACTER;
+    }
+    size_t   length  = 0;
+    uint32_t bits    = 0;
+    int      count   = 0;
+    size_t   padding = 0;
+    for (size_t i = 0; i < slen; i++)
+    {
+        if (src[i] == '=')
+        {
+            if (++padding > 2 || i < slen - 2)
+            {
+                return MBEDTLS_ERR_BASE64_INVALID_CHARACTER;
+            }
+            bits <<= 6;
+        }
+        else
+        {
+            const char* found = src[i] ? strchr(Alphabet, src[i]) : nullptr;
+            if (nullptr == found || padding > 0)
+            {
+                return MBEDTLS_ERR_BASE64_INVALID_CHARACTER;
+            }
+            bits = bits << 6 | (found - Alphabet);
+        }
+        if (++count == 4)
+        {
+            if (length + 3 - padding > dlen)
+            {
+                *olen = slen / 4 * 3 - padding;
+                return MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL;
+            }
+            for (size_t j = 0; j < 3 - padding; j++)
+            {
+                dst[length++] = bits >> (16 - 8 * j);
+            }
+            bits  = 0;
+            count = 0;
+        }
+    }
+    *olen = length;
+    return 0;
+}
@@ -0,0 +1,144 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// InternalMqttBroker with scripted connections: the fake AsyncServer accepts a peer, the test sends its packets and
+// calls the broker loop like the device task does.
+// --------------------------------------------------------------------------------------------------------------------
+#include "InternalMqtt/InternalMqtt.h"
+
+#include <AsyncTCP.h>
+#include <unity.h>
+
+static InternalMqttBroker* broker = nullptr;
+
+static std::string packet(uint8_t header, const std::string& body)
+{
+    return std::string(1, header) + std::string(1, static_cast<char>(body.size())) + body;
+}
+
+static std::string lengthPrefixed(const std::string& text)
+{
+    return std::string(1, static_cast<char>(text.size() >> 8)) + std::string(1, static_cast<char>(text.size() & 0xFF)) + text;
+}
+
+static std::string connectPacket(const std::string& clientId)
+{
+    // protocol name, level 4 (3.1.1), clean session, keep alive 60 s
+    return packet(MqttMessage::Connect, lengthPrefixed("MQTT") + std::string("\x04\x02\x00\x3C", 4) + lengthPrefixed(clientId));
+}
+
+/// @brief Connects a peer to the broker and checks the ConnAck.
+static AsyncClient* connect(const std::string& clientId)
+{
+    AsyncClient* peer = AsyncServer::listening->accept();
+    broker->loop(); // adopts the connection
+    peer->receive(connectPacket(clientId));
+    broker->loop();
+    TEST_ASSERT_TRUE(peer->takeSent() == std::string("\x20\x02\x00\x00", 4));
+    return peer;
+}
+
+void setUp()
+{
+    broker = new InternalMqttBroker(1883);
+    broker->begin();
+}
+
+void tearDown()
+{
+    delete broker;
+    broker = nullptr;
+    TEST_ASSERT_EQUAL(0, AsyncClient::instances);
+    TEST_ASSERT_EQUAL(0, Fake::pbufsAllocated);
+}
+
+void test_connect()
+{
+    connect("test");
+    TEST_ASSERT_EQUAL(1, broker->clientsCount());
+}
+
+void test_unknown_type_closes_connection()
+{
+    connect("test");
+    AsyncClient* peer = AsyncServer::listening->accept();
+    broker->loop();
+    peer->receive(std::string("\x00\x00\xC0\x00", 4)); // type 0, complete with length 0, then a PingReq
+    broker->loop();                                    // must not spin
+    broker->loop();
+    TEST_ASSERT_EQUAL(1, AsyncClient::instances); // only the first connection is left
+    TEST_ASSERT_EQUAL(1, broker->clientsCount());
+}
+
+void test_publish_to_subscriber()
+{
+    AsyncClient* subscriber = connect("subscriber");
+    AsyncClient* publisher  = connect("publisher");
+
+    subscriber->receive(packet(MqttMessage::Subscribe | 2, std::string("\x00\x01", 2) + lengthPrefixed("t/#") + std::string(1, '\0')));
+    broker->loop();
+    subscriber->takeSent();
+
+    publisher->receive(packet(MqttMessage::Publish, lengthPrefixed("t/1") + "hello"));
+    broker->loop();
+    TEST_ASSERT_TRUE(subscriber->takeSent() == packet(MqttMessage::Publish, lengthPrefixed("t/1") + "hello"));
+    TEST_ASSERT_TRUE(publisher->takeSent().empty());
+}
+
+void test_disconnect_deletes_client()
+{
+    connect("first");
+    AsyncClient* second = connect("second");
+    TEST_ASSERT_EQUAL(2, broker->clientsCount());
+
+    second->receive(packet(MqttMessage::Disconnect, ""));
+    broker->loop(); // closes the connection, the client stays until the broker deletes it
+    TEST_ASSERT_EQUAL(2, broker->clientsCount());
+    TEST_ASSERT_FALSE(broker->getClients()[1]->connected());
+    broker->loop();
+    TEST_ASSERT_EQUAL(1, broker->clientsCount());
+    TEST_ASSERT_EQUAL(1, AsyncClient::instances);
+}
+
+void test_malformed_packet_deletes_client()
+{
+    connect("first");
+    AsyncClient* second = connect("second");
+
+    second->receive(packet(0xF0, "")); // reserved type
+    broker->loop();
+    TEST_ASSERT_EQUAL(2, broker->clientsCount());
+    broker->loop();
+    TEST_ASSERT_EQUAL(1, broker->clientsCount());
+    TEST_ASSERT_EQUAL(1, AsyncClient::instances);
+}
+
+void test_disconnect_does_not_skip_next_client()
+{
+    AsyncClient* first  = connect("first");
+    AsyncClient* second = connect("second");
+
+    first->receive(packet(MqttMessage::Disconnect, ""));
+    second->receive(packet(MqttMessage::PingReq, ""));
+    broker->loop(); // both in the same loop
+    TEST_ASSERT_TRUE(second->takeSent() == packet(MqttMessage::PingResp, ""));
+    broker->loop();
+    TEST_ASSERT_EQUAL(1, broker->clientsCount());
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_connect);
+    RUN_TEST(test_unknown_type_closes_connection);
+    RUN_TEST(test_publish_to_subscriber);
+    RUN_TEST(test_disconnect_deletes_client);
+    RUN_TEST(test_malformed_packet_deletes_client);
+    RUN_TEST(test_disconnect_does_not_skip_next_client);
+    return UNITY_END();
+}
@@ -0,0 +1,111 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Gps: recorded NMEA data is replayed on the fake Serial2 in arbitrary chunks, like the uart event task delivers it.
+// --------------------------------------------------------------------------------------------------------------------
+#include "Gps.hpp"
+
+#include <unity.h>
+
+using namespace IotZoo;
+
+class TestMqttClient : public MqttClient
+{
+  public:
+    TestMqttClient() : MqttClient("test", "ssid", "password", "127.0.0.1")
+    {
+    }
+
+    std::vector<EspMQTTClient::Publish> takePublished()
+    {
+        return mqttClient->takePublished();
+    }
+};
+
+static const unsigned long PublishIntervalMs = 1000;
+
+static const char* Fix1 = "$GPRMC,173036.00,A,5237.80000,N,00936.60000,E,0.1,0.0,051025,,,A*5D\r\n"
+                          "$GPGGA,173037.00,5237.80600,N,00936.61200,E,1,08,0.9,32.1,M,46.9,M,,*53\r\n";
+static const char* Fix2 = "$GNGGA,173040.00,5237.90000,N,00936.70000,E,1,08,0.9,33.5,M,46.9,M,,*4D\r\n";
+static const char* NoFix = "$GPGGA,173038.00,,,,,0,00,99.9,,,,,,*51\r\n"
+                           "$GPRMC,173038.00,V,,,,,,,051025,,,N*70\r\n"
+                           "$GPRMC,173039.00,A,5237.80000,N,00936.60000,E,0.1,0.0,051025,,,A*5D\r\n"; // wrong checksum
+
+static TestMqttClient* mqttClient = nullptr;
+static Gps*            gps        = nullptr;
+
+/// @brief Sends the recorded data in chunks of chunkSize bytes, so sentences are split anywhere.
+static void replay(const char* nmea, size_t chunkSize)
+{
+    std::string data(nmea);
+    for (size_t offset = 0; offset < data.size(); offset += chunkSize)
+    {
+        Serial2.receive(data.substr(offset, chunkSize));
+    }
+}
+
+void setUp()
+{
+    mqttClient = new TestMqttClient();
+    gps        = new Gps(0, nullptr, mqttClient, "iotzoo/test", 16, 17, 9600, PublishIntervalMs);
+    Fake::advanceMillis(PublishIntervalMs);
+}
+
+void tearDown()
+{
+    delete gps;
+    delete mqttClient;
+}
+
+void test_publishes_latest_fix()
+{
+    replay(Fix1, 7);
+    gps->loop();
+    auto published = mqttClient->takePublished();
+    TEST_ASSERT_EQUAL(1, published.size());
+    TEST_ASSERT_EQUAL_STRING("iotzoo/test/gps/position0", published[0].topic.c_str());
+    TEST_ASSERT_EQUAL_STRING("{ \"Lat\": 52.630, \"Lon\": 9.610, \"Alt\": 32.1, \"DateTimeUtc\": \"2025-10-05 17:30:37\"}",
+                             published[0].payload.c_str());
+
+    gps->loop(); // no new fix
+    TEST_ASSERT_TRUE(mqttClient->takePublished().empty());
+}
+
+void test_publish_interval()
+{
+    replay(Fix1, 64);
+    gps->loop();
+    mqttClient->takePublished();
+
+    replay(Fix2, 1);
+    gps->loop(); // within publishIntervalMs
+    TEST_ASSERT_TRUE(mqttClient->takePublished().empty());
+
+    Fake::advanceMillis(PublishIntervalMs);
+    gps->loop();
+    auto published = mqttClient->takePublished();
+    TEST_ASSERT_EQUAL(1, published.size());
+    TEST_ASSERT_EQUAL_STRING("{ \"Lat\": 52.632, \"Lon\": 9.612, \"Alt\": 33.5, \"DateTimeUtc\": \"2025-10-05 17:30:40\"}",
+                             published[0].payload.c_str());
+}
+
+void test_no_fix_is_not_published()
+{
+    replay(NoFix, 13);
+    gps->loop();
+    TEST_ASSERT_TRUE(mqttClient->takePublished().empty());
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_publishes_latest_fix);
+    RUN_TEST(test_publish_interval);
+    RUN_TEST(test_no_fix_is_not_published);
+    return UNITY_END();
+}
@@ -0,0 +1,106 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// MqttClient on the fake EspMQTTClient: publishes kept while offline, also when they come from another task.
+// --------------------------------------------------------------------------------------------------------------------
+#include "Defines.hpp"
+#include "MqttClient.hpp"
+
+#include <thread>
+#include <unity.h>
+
+using namespace IotZoo;
+
+class TestMqttClient : public MqttClient
+{
+  public:
+    TestMqttClient() : MqttClient("test", "ssid", "password", "127.0.0.1")
+    {
+    }
+
+    EspMQTTClient* fake()
+    {
+        return mqttClient;
+    }
+};
+
+static TestMqttClient* client = nullptr;
+
+void setUp()
+{
+    client = new TestMqttClient();
+}
+
+void tearDown()
+{
+    delete client;
+}
+
+void test_offline_publishes_sent_in_order()
+{
+    client->fake()->setConnected(false);
+    client->publish("t/event", "1");
+    client->publishState("t/state", "a");
+    client->publish("t/event", "2");
+    client->publishState("t/state", "b"); // replaces "a"
+    TEST_ASSERT_EQUAL(3, client->getPendingCount());
+    TEST_ASSERT_EQUAL(1, client->getPendingCoalesced());
+
+    client->fake()->setConnected(true);
+    client->publish("t/event", "3"); // behind the waiting ones
+    client->loop();
+    auto published = client->fake()->takePublished();
+    TEST_ASSERT_EQUAL(4, published.size());
+    TEST_ASSERT_EQUAL_STRING("1", published[0].payload.c_str());
+    TEST_ASSERT_EQUAL_STRING("b", published[1].payload.c_str());
+    TEST_ASSERT_EQUAL_STRING("2", published[2].payload.c_str());
+    TEST_ASSERT_EQUAL_STRING("3", published[3].payload.c_str());
+    TEST_ASSERT_EQUAL(0, client->getPendingCount());
+}
+
+void test_publishes_of_another_task_while_loop_drains()
+{
+    const int Publishes = 20000;
+    client->fake()->setConnected(false);
+
+    // like a NimBLE callback publishing the heart rate
+    std::thread other(
+        []()
+        {
+            for (int i = 0; i < Publishes; i++)
+            {
+                client->publish("t/heart_rate", String(i));
+            }
+        });
+    for (int i = 0; client->getPendingCount() > 0 || i < 2000; i++)
+    {
+        client->fake()->setConnected(i % 3 != 0);
+        client->loop();
+    }
+    other.join();
+    client->fake()->setConnected(true);
+    while (client->getPendingCount() > 0)
+    {
+        client->loop();
+    }
+
+    auto published = client->fake()->takePublished();
+    TEST_ASSERT_EQUAL(Publishes, published.size() + client->getPendingDropped());
+    for (size_t i = 1; i < published.size(); i++)
+    {
+        TEST_ASSERT_TRUE(published[i - 1].payload.toInt() < published[i].payload.toInt()); // in order
+    }
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_offline_publishes_sent_in_order);
+    RUN_TEST(test_publishes_of_another_task_while_loop_drains);
+    return UNITY_END();
+}
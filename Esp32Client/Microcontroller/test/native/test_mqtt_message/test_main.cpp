@@ -0,0 +1,121 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// MqttMessage: building Publish packets, the overflow, and the throughput for payloads from 16 bytes to 4 KB.
+// --------------------------------------------------------------------------------------------------------------------
+#include "InternalMqtt/InternalMqtt.h"
+
+#include <chrono>
+#include <unity.h>
+
+static const char* TopicName = "iotzoo/picea/esp32/e4:65:b8:b0:45:b4/tm1637_4/0/number";
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static void buildPublish(MqttMessage& msg, const InternalTopic& topic, const char* payload, size_t length)
+{
+    msg.create(MqttMessage::Publish, 2 + topic.str().length() + length);
+    msg.add(topic);
+    msg.add(payload, length, false);
+    msg.complete();
+}
+
+void test_publish_short()
+{
+    InternalTopic topic(TopicName);
+    MqttMessage   msg;
+    buildPublish(msg, topic, "42", 2);
+
+    const char* vheader = msg.getVHeader();
+    size_t      length  = 2 + strlen(TopicName) + 2;
+    TEST_ASSERT_EQUAL(MqttMessage::Publish, msg.type());
+    TEST_ASSERT_EQUAL(length, msg.end() - vheader);
+    TEST_ASSERT_EQUAL(length, static_cast<uint8_t>(vheader[-1])); // one length byte
+    TEST_ASSERT_EQUAL(MqttMessage::Publish, static_cast<uint8_t>(vheader[-2]));
+    TEST_ASSERT_EQUAL(strlen(TopicName), MqttMessage::getSize(vheader));
+    TEST_ASSERT_TRUE(memcmp(vheader + 2, TopicName, strlen(TopicName)) == 0);
+    TEST_ASSERT_TRUE(memcmp(msg.end() - 2, "42", 2) == 0);
+}
+
+void test_publish_long()
+{
+    InternalTopic topic(TopicName);
+    std::string   payload(1000, 'x');
+    MqttMessage   msg;
+    buildPublish(msg, topic, payload.data(), payload.size());
+
+    const char* vheader = msg.getVHeader();
+    size_t      length  = 2 + strlen(TopicName) + payload.size();
+    TEST_ASSERT_EQUAL(length, msg.end() - vheader);
+    TEST_ASSERT_EQUAL(0x80 | (length & 0x7F), static_cast<uint8_t>(vheader[-2])); // two length bytes
+    TEST_ASSERT_EQUAL(length >> 7, static_cast<uint8_t>(vheader[-1]));
+    TEST_ASSERT_EQUAL(MqttMessage::Publish, static_cast<uint8_t>(vheader[-3]));
+}
+
+void test_overflow_sends_nothing()
+{
+    InternalMqttClient client(nullptr, "test");
+    InternalTopic      topic(TopicName);
+    std::string        payload(5000, 'x');
+    MqttMessage        msg;
+
+    msg.create(MqttMessage::Publish);
+    msg.add(topic);
+    msg.add(payload.data(), payload.size(), false); // too long
+    msg.add('\x30');                               // must not restart parsing
+    msg.add('\x02');
+    msg.add("ab", 2, false);
+    msg.add(topic);
+    msg.complete();
+
+    TEST_ASSERT_EQUAL(MqttMessage::Unknown, msg.type());
+    TEST_ASSERT_EQUAL(MqttInvalidMessage, msg.sendTo(&client));
+
+    msg.reset(); // usable again
+    buildPublish(msg, topic, "1", 1);
+    TEST_ASSERT_EQUAL(MqttMessage::Publish, msg.type());
+}
+
+void test_benchmark_build_publish()
+{
+    InternalTopic topic(TopicName);
+    std::string   payload(4096, 'x');
+    for (size_t length : {16, 64, 256, 1024, 4000})
+    {
+        const int Messages = 200000 / length + 100;
+        size_t    bytes    = 0;
+        auto      start    = std::chrono::steady_clock::now();
+        for (int i = 0; i < Messages; i++)
+        {
+            MqttMessage msg;
+            buildPublish(msg, topic, payload.data(), length);
+            bytes += msg.end() - msg.getVHeader();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        char   message[96];
+        snprintf(message, sizeof(message), "%4zu B payload: %8.1f MB/s", length, bytes / seconds / 1e6);
+        TEST_MESSAGE(message);
+        TEST_ASSERT_EQUAL(Messages * (2 + strlen(TopicName) + length), bytes);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_publish_short);
+    RUN_TEST(test_publish_long);
+    RUN_TEST(test_overflow_sends_nothing);
+    RUN_TEST(test_benchmark_build_publish);
+    return UNITY_END();
+}
@@ -0,0 +1,189 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// PixelEffects: the frames of fade, blink and chase at given times, blending, replacing and ending effects.
+// --------------------------------------------------------------------------------------------------------------------
+#include "Defines.hpp"
+#include "PixelEffects.hpp"
+
+#include <unity.h>
+
+using namespace IotZoo;
+
+class TestPixelEffects : public PixelEffects
+{
+  public:
+    size_t getCount() const
+    {
+        return effects.size();
+    }
+
+    const PixelEffect& getEffect(size_t index) const
+    {
+        return effects[index];
+    }
+
+    /// @brief Renders the frame elapsed milliseconds after the first effect was started.
+    bool renderAt(unsigned long elapsed)
+    {
+        return render(effects.empty() ? 0 : effects[0].StartMillis + elapsed, 1, colors, NumberOfPixels, first, last);
+    }
+
+    static const uint16_t NumberOfPixels = 8;
+
+    uint32_t colors[NumberOfPixels] = {};
+    uint16_t first                  = 0;
+    uint16_t last                   = 0;
+};
+
+static TestPixelEffects* effects = nullptr;
+
+static PixelEffect createEffect(PixelEffectType type, uint16_t startIndex, uint16_t length, uint32_t color, uint32_t color2,
+                                uint16_t periodMs)
+{
+    PixelEffect effect;
+    effect.Type       = type;
+    effect.StartIndex = startIndex;
+    effect.Length     = length;
+    effect.Color      = color;
+    effect.Color2     = color2;
+    effect.PeriodMs   = periodMs;
+    return effect;
+}
+
+void setUp()
+{
+    effects = new TestPixelEffects();
+}
+
+void tearDown()
+{
+    delete effects;
+}
+
+void test_fade_ends_exactly_at_color2()
+{
+    TEST_ASSERT_TRUE(effects->start(createEffect(PixelEffectType::Fade, 0, 2, 0x102030, 0xF0E0D0, 1000)));
+    effects->renderAt(0);
+    TEST_ASSERT_EQUAL_HEX32(0x102030, effects->colors[0]);
+    effects->renderAt(500);
+    TEST_ASSERT_EQUAL_HEX32(0x808080, effects->colors[0]);
+    effects->renderAt(999);
+    TEST_ASSERT_EQUAL_HEX32(0xEFDFCF, effects->colors[0]); // fraction 65470, rounded down per channel
+    TEST_ASSERT_TRUE(effects->renderAt(1000));
+    TEST_ASSERT_EQUAL_HEX32(0xF0E0D0, effects->colors[0]);
+    TEST_ASSERT_EQUAL_HEX32(0xF0E0D0, effects->colors[1]);
+    TEST_ASSERT_TRUE(effects->isEmpty()); // stays color2
+}
+
+void test_blink_switches_at_half_period()
+{
+    effects->start(createEffect(PixelEffectType::Blink, 0, 1, 0xFF0000, 0x0000FF, 1000));
+    effects->renderAt(499);
+    TEST_ASSERT_EQUAL_HEX32(0xFF0000, effects->colors[0]);
+    effects->renderAt(500);
+    TEST_ASSERT_EQUAL_HEX32(0x0000FF, effects->colors[0]);
+    effects->renderAt(999);
+    TEST_ASSERT_EQUAL_HEX32(0x0000FF, effects->colors[0]);
+    effects->renderAt(1000);
+    TEST_ASSERT_EQUAL_HEX32(0xFF0000, effects->colors[0]);
+}
+
+void test_chase_wraps_around()
+{
+    PixelEffect chase = createEffect(PixelEffectType::Chase, 2, 4, 0x00FF00, 0x000010, 400);
+    chase.Width       = 2;
+    effects->start(chase);
+    effects->renderAt(0);
+    TEST_ASSERT_EQUAL_HEX32(0x00FF00, effects->colors[2]);
+    TEST_ASSERT_EQUAL_HEX32(0x00FF00, effects->colors[3]);
+    TEST_ASSERT_EQUAL_HEX32(0x000010, effects->colors[4]);
+
+    effects->renderAt(300); // the head is on the last pixel of the range, the tail on the first one
+    TEST_ASSERT_EQUAL_HEX32(0x00FF00, effects->colors[2]);
+    TEST_ASSERT_EQUAL_HEX32(0x000010, effects->colors[3]);
+    TEST_ASSERT_EQUAL_HEX32(0x000010, effects->colors[4]);
+    TEST_ASSERT_EQUAL_HEX32(0x00FF00, effects->colors[5]);
+    TEST_ASSERT_EQUAL_HEX32(0, effects->colors[1]); // outside of the range
+    TEST_ASSERT_EQUAL_HEX32(0, effects->colors[6]);
+}
+
+void test_opacity_blends_over_the_effects_started_before()
+{
+    PixelEffect red  = createEffect(PixelEffectType::Blink, 0, 4, 0xFF0000, 0xFF0000, 1000);
+    PixelEffect blue = createEffect(PixelEffectType::Blink, 2, 4, 0x0000FF, 0x0000FF, 1000);
+    blue.Opacity     = 128;
+    effects->start(red);
+    effects->start(blue);
+    effects->renderAt(0);
+    TEST_ASSERT_EQUAL_HEX32(0xFF0000, effects->colors[1]);
+    TEST_ASSERT_EQUAL_HEX32(0x7F007F, effects->colors[2]); // blue at half over red
+    TEST_ASSERT_EQUAL_HEX32(0x00007F, effects->colors[4]); // blue at half over nothing
+
+    // The other way round the opaque red covers the blue.
+    effects->stop();
+    red.StartIndex  = 2;
+    blue.StartIndex = 0;
+    effects->start(blue);
+    effects->start(red);
+    effects->renderAt(0);
+    TEST_ASSERT_EQUAL_HEX32(0x00007F, effects->colors[1]);
+    TEST_ASSERT_EQUAL_HEX32(0xFF0000, effects->colors[2]);
+}
+
+void test_same_range_replaces_the_effect()
+{
+    effects->start(createEffect(PixelEffectType::Blink, 1, 3, 0xFF0000, 0, 1000));
+    effects->start(createEffect(PixelEffectType::Blink, 1, 2, 0x00FF00, 0, 1000)); // other range
+    effects->start(createEffect(PixelEffectType::Chase, 1, 3, 0x0000FF, 0, 500));
+    TEST_ASSERT_EQUAL(2, effects->getCount());
+    TEST_ASSERT_TRUE(PixelEffectType::Chase == effects->getEffect(0).Type);
+    TEST_ASSERT_EQUAL_HEX32(0x0000FF, effects->getEffect(0).Color);
+}
+
+void test_max_effects()
+{
+    for (uint16_t index = 0; index < PixelEffects::MaxEffects; index++)
+    {
+        TEST_ASSERT_TRUE(effects->start(createEffect(PixelEffectType::Blink, index, 1, 0xFF0000, 0, 1000)));
+    }
+    TEST_ASSERT_FALSE(effects->start(createEffect(PixelEffectType::Blink, 0, 2, 0xFF0000, 0, 1000)));
+    TEST_ASSERT_TRUE(effects->start(createEffect(PixelEffectType::Fade, 3, 1, 0xFF0000, 0, 1000))); // replaces one
+    TEST_ASSERT_EQUAL(PixelEffects::MaxEffects, effects->getCount());
+}
+
+void test_duration_turns_the_pixels_off()
+{
+    PixelEffect blink = createEffect(PixelEffectType::Blink, 2, 3, 0xFF0000, 0x00FF00, 200);
+    blink.DurationMs  = 1000;
+    effects->start(blink);
+    effects->renderAt(999);
+    TEST_ASSERT_EQUAL_HEX32(0x00FF00, effects->colors[2]);
+
+    TEST_ASSERT_TRUE(effects->renderAt(1000));
+    TEST_ASSERT_TRUE(effects->isEmpty());
+    for (uint16_t index = 2; index < 5; index++)
+    {
+        TEST_ASSERT_EQUAL_HEX32(0, effects->colors[index]);
+    }
+    TEST_ASSERT_EQUAL(2, effects->first);
+    TEST_ASSERT_EQUAL(4, effects->last);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fade_ends_exactly_at_color2);
+    RUN_TEST(test_blink_switches_at_half_period);
+    RUN_TEST(test_chase_wraps_around);
+    RUN_TEST(test_opacity_blends_over_the_effects_started_before);
+    RUN_TEST(test_same_range_replaces_the_effect);
+    RUN_TEST(test_max_effects);
+    RUN_TEST(test_duration_turns_the_pixels_off);
+    return UNITY_END();
+}
@@ -0,0 +1,145 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// WS2818::setPixelsByFrame(): binary frames in RGB, palette and run length encoding; invalid frames change no pixel.
+// --------------------------------------------------------------------------------------------------------------------
+#include "Defines.hpp"
+#include "MqttClient.hpp"
+#include "WS2818.hpp"
+
+#include <unity.h>
+
+using namespace IotZoo;
+
+class TestMqttClient : public MqttClient
+{
+  public:
+    TestMqttClient() : MqttClient("test", "ssid", "password", "127.0.0.1")
+    {
+    }
+
+    EspMQTTClient* fake()
+    {
+        return mqttClient;
+    }
+};
+
+class TestWS2818 : public WS2818
+{
+  public:
+    TestWS2818(MqttClient* mqttClient) : WS2818(0, nullptr, mqttClient, "iotzoo", 22, NumberOfLeds)
+    {
+    }
+
+    const vector<uint32_t>& getColors() const
+    {
+        return colors;
+    }
+
+    static const uint NumberOfLeds = 8;
+};
+
+static TestMqttClient* client = nullptr;
+static TestWS2818*     strip  = nullptr;
+
+void setUp()
+{
+    client = new TestMqttClient();
+    client->fake()->setConnected(true);
+    strip = new TestWS2818(client);
+    client->fake()->takePublished();
+}
+
+void tearDown()
+{
+    delete strip;
+    delete client;
+}
+
+/// @brief Sets frame, which must be rejected with the error starting with expected, and checks that no pixel changed.
+static void assertRejected(const vector<uint8_t>& frame, const char* expected)
+{
+    vector<uint32_t> before = strip->getColors();
+    TEST_ASSERT_FALSE(strip->setPixelsByFrame(frame.data(), frame.size()));
+    TEST_ASSERT_TRUE(before == strip->getColors());
+
+    auto published = client->fake()->takePublished();
+    TEST_ASSERT_EQUAL(1, published.size());
+    TEST_ASSERT_EQUAL_STRING("iotzoo/error", published[0].topic.c_str());
+    TEST_ASSERT_TRUE(published[0].payload.startsWith(expected));
+}
+
+void test_rgb_frame()
+{
+    vector<uint8_t> frame = {0, 2, 0, 2, 0, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
+    TEST_ASSERT_TRUE(strip->setPixelsByFrame(frame.data(), frame.size()));
+    const auto& colors = strip->getColors();
+    TEST_ASSERT_EQUAL_HEX32(0, colors[1]);
+    TEST_ASSERT_EQUAL_HEX32(0x112233, colors[2]);
+    TEST_ASSERT_EQUAL_HEX32(0x445566, colors[3]);
+    TEST_ASSERT_EQUAL_HEX32(0, colors[4]);
+}
+
+void test_palette_frame()
+{
+    // 2 colors, then the indexes of 4 pixels
+    vector<uint8_t> frame = {1, 0, 0, 4, 0, 2, 0xFF, 0, 0, 0, 0, 0xFF, 1, 0, 0, 1};
+    TEST_ASSERT_TRUE(strip->setPixelsByFrame(frame.data(), frame.size()));
+    const auto& colors = strip->getColors();
+    TEST_ASSERT_EQUAL_HEX32(0x0000FF, colors[0]);
+    TEST_ASSERT_EQUAL_HEX32(0xFF0000, colors[1]);
+    TEST_ASSERT_EQUAL_HEX32(0xFF0000, colors[2]);
+    TEST_ASSERT_EQUAL_HEX32(0x0000FF, colors[3]);
+    TEST_ASSERT_EQUAL_HEX32(0, colors[4]);
+}
+
+void test_palette_rle_frame()
+{
+    // 8 pixels in 2 runs: 5 times color 1, 3 times color 0
+    vector<uint8_t> frame = {0x81, 0, 0, 8, 0, 2, 0, 0x80, 0, 0, 0, 0x80, 5, 1, 3, 0};
+    TEST_ASSERT_TRUE(strip->setPixelsByFrame(frame.data(), frame.size()));
+    const auto& colors = strip->getColors();
+    for (uint index = 0; index < 5; index++)
+    {
+        TEST_ASSERT_EQUAL_HEX32(0x000080, colors[index]);
+    }
+    for (uint index = 5; index < TestWS2818::NumberOfLeds; index++)
+    {
+        TEST_ASSERT_EQUAL_HEX32(0x008000, colors[index]);
+    }
+}
+
+void test_invalid_frames_change_no_pixel()
+{
+    vector<uint8_t> frame = {0, 0, 0, 8, 0};
+    for (int index = 0; index < 8; index++)
+    {
+        frame.insert(frame.end(), {0x10, 0x20, uint8_t(index)});
+    }
+    TEST_ASSERT_TRUE(strip->setPixelsByFrame(frame.data(), frame.size()));
+
+    assertRejected({0, 0, 0, 1}, "frame: too short");
+    // palette of 3 colors, but only 2 in the payload
+    assertRejected({1, 0, 0, 1, 0, 3, 1, 2, 3, 4, 5, 6}, "frame: palette incomplete");
+    // runs of 6 and 3 pixels, but only 8 pixels in the frame
+    assertRejected({0x81, 0, 0, 8, 0, 1, 9, 9, 9, 6, 0, 3, 0}, "frame: length does not match");
+    // color index 2 of a palette with 2 colors
+    assertRejected({1, 0, 0, 2, 0, 2, 1, 1, 1, 2, 2, 2, 0, 2}, "frame: length does not match");
+    // pixels 6 ... 8 of 8
+    assertRejected({0, 6, 0, 3, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3}, "frame: pixels out of range");
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_rgb_frame);
+    RUN_TEST(test_palette_frame);
+    RUN_TEST(test_palette_rle_frame);
+    RUN_TEST(test_invalid_frames_change_no_pixel);
+    return UNITY_END();
+}
@@ -0,0 +1,122 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// Settings on the fake Preferences: read from the flash once, changes written back deferred.
+// --------------------------------------------------------------------------------------------------------------------
+#include "Settings.hpp"
+
+#include <thread>
+#include <unity.h>
+
+using namespace IotZoo;
+
+static std::map<std::string, std::string>& flash()
+{
+    return Fake::Nvs::namespaces["config"];
+}
+
+void setUp()
+{
+    Fake::Nvs::clear();
+    flash()["ProjectName"]    = "picea";
+    flash()["interval_alive"] = "30000";
+}
+
+void tearDown()
+{
+}
+
+void test_read_from_flash_once()
+{
+    Settings settings;
+    unsigned reads  = Fake::Nvs::reads;
+    unsigned begins = Fake::Nvs::begins;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        TEST_ASSERT_EQUAL(30000, settings.getAliveIntervalMillis());
+        TEST_ASSERT_EQUAL(2, settings.getAliveAckLedMode()); // fallback, not in the flash
+        TEST_ASSERT_EQUAL_STRING("picea", settings.getProjectName("fallback").c_str());
+    }
+    TEST_ASSERT_EQUAL(reads, Fake::Nvs::reads);
+    TEST_ASSERT_EQUAL(begins, Fake::Nvs::begins);
+    TEST_ASSERT_EQUAL_STRING("iotzoo", settings.getNamespaceName("iotzoo").c_str());
+}
+
+void test_changes_written_back_deferred()
+{
+    Settings settings;
+    settings.setAliveIntervalMillis(15000);
+    settings.setAliveIntervalMillis(20000);
+    settings.setNamespaceName("ns");
+    settings.setProjectName("picea"); // unchanged
+    TEST_ASSERT_EQUAL(20000, settings.getAliveIntervalMillis());
+
+    settings.loop();
+    TEST_ASSERT_EQUAL(0, Fake::Nvs::writes);
+
+    Fake::advanceMillis(2001);
+    settings.loop();
+    TEST_ASSERT_EQUAL(2, Fake::Nvs::writes); // each changed setting once
+    TEST_ASSERT_TRUE(flash()["interval_alive"] == "20000");
+    TEST_ASSERT_TRUE(flash()["NamespaceName"] == "ns");
+
+    settings.loop();
+    TEST_ASSERT_EQUAL(2, Fake::Nvs::writes);
+}
+
+void test_flush_on_destruction()
+{
+    {
+        Settings settings;
+        settings.setAliveLedMode(1);
+        settings.saveDeviceConfigurations("[]");
+    }
+    TEST_ASSERT_EQUAL(2, Fake::Nvs::writes);
+    TEST_ASSERT_TRUE(flash()["alive_led"] == "1");
+
+    Settings settings; // reads what was written
+    TEST_ASSERT_EQUAL(1, settings.getAliveAckLedMode());
+    TEST_ASSERT_EQUAL_STRING("[]", settings.loadDeviceConfigurations().c_str());
+}
+
+void test_setters_of_another_task()
+{
+    Settings settings;
+    // like the REST server on the network core
+    std::thread other(
+        [&settings]()
+        {
+            for (long interval = 1; interval <= 20000; interval++)
+            {
+                settings.setAliveIntervalMillis(interval);
+            }
+        });
+    long last = 0;
+    for (int i = 0; i < 20000; i++)
+    {
+        long interval = settings.getAliveIntervalMillis();
+        TEST_ASSERT_TRUE(interval >= last || last == 30000); // never a torn or older value
+        last = interval;
+        settings.loop();
+    }
+    other.join();
+    TEST_ASSERT_EQUAL(20000, settings.getAliveIntervalMillis());
+    TEST_ASSERT_TRUE(settings.flush());
+    TEST_ASSERT_TRUE(flash()["interval_alive"] == "20000");
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_read_from_flash_once);
+    RUN_TEST(test_changes_written_back_deferred);
+    RUN_TEST(test_flush_on_destruction);
+    RUN_TEST(test_setters_of_another_task);
+    return UNITY_END();
+}
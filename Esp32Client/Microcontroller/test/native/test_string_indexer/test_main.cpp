@@ -0,0 +1,65 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// StringIndexer: interning, reuse of released indexes and the memory statistics.
+// --------------------------------------------------------------------------------------------------------------------
+#include "InternalMqtt/StringIndexer.h"
+
+#include <unity.h>
+
+static const string LongTopic = "iotzoo/picea/esp32/e4:65:b8:b0:45:b4/tm1637_4/0/number";
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_same_string_same_index()
+{
+    StringIndexer::Stats before = StringIndexer::stats();
+    IndexedString        first(LongTopic);
+    IndexedString        second(LongTopic);
+    IndexedString        other("other", 5);
+
+    TEST_ASSERT_TRUE(first.valid());
+    TEST_ASSERT_TRUE(first == second);
+    TEST_ASSERT_FALSE(first == other);
+    TEST_ASSERT_TRUE(first.str() == LongTopic);
+    TEST_ASSERT_EQUAL(before.misses + 2, StringIndexer::stats().misses);
+    TEST_ASSERT_EQUAL(before.hits + 1, StringIndexer::stats().hits);
+}
+
+void test_release_frees_memory()
+{
+    size_t                 memoryBefore = StringIndexer::memoryUsed();
+    uint16_t               countBefore  = StringIndexer::count();
+    StringIndexer::index_t index;
+    {
+        IndexedString topic(LongTopic);
+        index = topic.getIndex();
+        TEST_ASSERT_EQUAL(countBefore + 1, StringIndexer::count());
+        TEST_ASSERT_GREATER_OR_EQUAL(memoryBefore + LongTopic.length(), StringIndexer::memoryUsed());
+    }
+    TEST_ASSERT_EQUAL(countBefore, StringIndexer::count());
+    TEST_ASSERT_TRUE(StringIndexer::str(index).empty());
+    TEST_ASSERT_LESS_THAN(LongTopic.length(), StringIndexer::str(index).capacity()); // the heap of the string is freed
+
+    IndexedString reused("reused", 6); // the released index is used again
+    TEST_ASSERT_EQUAL(index, reused.getIndex());
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_same_string_same_index);
+    RUN_TEST(test_release_frees_memory);
+    return UNITY_END();
+}
@@ -0,0 +1,110 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// DeviceBase::signalValueChanged(): TopicLinks published via the internal broker, Deadband and MinIntervalMs.
+// --------------------------------------------------------------------------------------------------------------------
+#include "DeviceBase.hpp"
+
+#include <unity.h>
+
+using namespace IotZoo;
+
+class TestDevice : public DeviceBase
+{
+  public:
+    TestDevice(InternalMqttClient* client) : DeviceBase(0, nullptr, nullptr, "iotzoo/test")
+    {
+        setInternalMqttClient(client);
+    }
+};
+
+static InternalMqttBroker*      broker     = nullptr;
+static InternalMqttClient*      subscriber = nullptr;
+static InternalMqttClient*      publisher  = nullptr;
+static TestDevice*              device     = nullptr;
+static std::vector<std::string> received;
+
+static void onPublish(const InternalMqttClient*, const InternalTopic&, const char* payload, size_t length)
+{
+    received.emplace_back(payload, length);
+}
+
+static void addTopicLink(float deadband, unsigned long minIntervalMs)
+{
+    TopicLink topicLink("iotzoo/test/sensor", "", "iotzoo/test/target", "input");
+    topicLink.Deadband      = deadband;
+    topicLink.MinIntervalMs = minIntervalMs;
+    device->setTopicLinks({topicLink});
+}
+
+void setUp()
+{
+    broker     = new InternalMqttBroker(1883);
+    subscriber = new InternalMqttClient(broker, "subscriber");
+    publisher  = new InternalMqttClient(broker, "device");
+    subscriber->setCallback(onPublish);
+    subscriber->subscribe(InternalTopic("iotzoo/test/target"));
+    device = new TestDevice(publisher);
+    received.clear();
+}
+
+void tearDown()
+{
+    delete device;
+    delete publisher;
+    delete subscriber;
+    delete broker;
+}
+
+void test_deadband()
+{
+    addTopicLink(1.0, 0);
+    device->signalValueChanged("iotzoo/test/sensor", "10");
+    device->signalValueChanged("iotzoo/test/sensor", "10.5"); // within the Deadband
+    device->signalValueChanged("iotzoo/test/sensor", "11.5");
+    TEST_ASSERT_TRUE((received == std::vector<std::string>{"10", "11.5"}));
+}
+
+void test_min_interval_publishes_latest_value_later()
+{
+    addTopicLink(0, 1000);
+    device->signalValueChanged("iotzoo/test/sensor", "10");
+    device->signalValueChanged("iotzoo/test/sensor", "20"); // within MinIntervalMs
+    device->signalValueChanged("iotzoo/test/sensor", "30");
+    device->loop();
+    TEST_ASSERT_TRUE((received == std::vector<std::string>{"10"}));
+
+    Fake::advanceMillis(1000);
+    device->loop();
+    TEST_ASSERT_TRUE((received == std::vector<std::string>{"10", "30"}));
+
+    Fake::advanceMillis(1000);
+    device->loop(); // published once only
+    TEST_ASSERT_EQUAL(2, received.size());
+}
+
+void test_min_interval_value_back_to_published()
+{
+    addTopicLink(0, 1000);
+    device->signalValueChanged("iotzoo/test/sensor", "10");
+    device->signalValueChanged("iotzoo/test/sensor", "20");
+    device->signalValueChanged("iotzoo/test/sensor", "10"); // the published value is current again
+
+    Fake::advanceMillis(1000);
+    device->loop();
+    TEST_ASSERT_TRUE((received == std::vector<std::string>{"10"}));
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_deadband);
+    RUN_TEST(test_min_interval_publishes_latest_value_later);
+    RUN_TEST(test_min_interval_value_back_to_published);
+    return UNITY_END();
+}
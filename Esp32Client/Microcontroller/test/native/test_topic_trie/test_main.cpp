@@ -0,0 +1,191 @@
+// --------------------------------------------------------------------------------------------------------------------
+//      ____    ______   _____
+//     /  _/___/_  __/  /__  / ____  ____
+//     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+//   _/ // /_/ / /       / /_/ /_/ / /_/ /
+//  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+//
+// --------------------------------------------------------------------------------------------------------------------
+// TopicTrie: wildcards, removal, and the comparison with the linear scan over InternalTopic::matches() it replaces.
+// --------------------------------------------------------------------------------------------------------------------
+#include "InternalMqtt/InternalMqtt.h"
+#include "InternalMqtt/TopicTrie.h"
+
+#include <algorithm>
+#include <chrono>
+#include <unity.h>
+
+using Matches = std::vector<int>;
+
+static Matches match(const TopicTrie<int>& trie, const char* topic)
+{
+    Matches result;
+    trie.match(topic, result);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_wildcards()
+{
+    TopicTrie<int> trie;
+    trie.insert("a/b/c", 1);
+    trie.insert("a/+/c", 2);
+    trie.insert("a/#", 3);
+    trie.insert("#", 4);
+    trie.insert("*/c", 5);
+    trie.insert("a/*/d", 6);
+
+    TEST_ASSERT_TRUE((match(trie, "a/b/c") == Matches{1, 2, 3, 4, 5}));
+    TEST_ASSERT_TRUE((match(trie, "a") == Matches{3, 4}));
+    TEST_ASSERT_TRUE((match(trie, "a/x/y/d") == Matches{3, 4, 6}));
+    TEST_ASSERT_TRUE((match(trie, "a/d") == Matches{3, 4, 6}));
+    TEST_ASSERT_TRUE(match(trie, "$SYS/c").empty()); // no wildcard at the first level for $ topics
+}
+
+void test_remove()
+{
+    TopicTrie<int> trie;
+    trie.insert("a/b/c", 1);
+    trie.insert("a/+/c", 2);
+    trie.insert("a/#", 3);
+    trie.insert("#", 4);
+
+    trie.remove("#", 4);
+    TEST_ASSERT_TRUE(match(trie, "q").empty());
+
+    trie.removeSubscriber(3);
+    TEST_ASSERT_TRUE((match(trie, "a/b/c") == Matches{1, 2}));
+
+    trie.removeSubscriber(1);
+    trie.removeSubscriber(2);
+    TEST_ASSERT_TRUE(trie.empty());
+}
+
+// 20 clients with 40 subscriptions each, like devices with their topics.
+static const int Clients       = 20;
+static const int Subscriptions = 40;
+
+static std::string filterOf(int client, int subscription)
+{
+    std::string filter = "iotzoo/picea/esp32/e4:65:b8:b0:45:b4/tm1637_4/" + std::to_string(client);
+    switch (subscription % 4)
+    {
+    case 0:
+        return filter + "/t" + std::to_string(subscription);
+    case 1:
+        return filter + "/+/t" + std::to_string(subscription);
+    case 2:
+        return filter + "/t" + std::to_string(subscription) + "/#";
+    default:
+        return "iotzoo/+/esp32/+/tm1637_4/" + std::to_string(client) + "/t" + std::to_string(subscription);
+    }
+}
+
+void test_same_result_as_linear_scan()
+{
+    std::vector<std::vector<InternalTopic>> filters(Clients);
+    TopicTrie<int>                          trie;
+    for (int client = 0; client < Clients; client++)
+    {
+        for (int subscription = 0; subscription < Subscriptions; subscription++)
+        {
+            std::string filter = filterOf(client, subscription);
+            filters[client].emplace_back(filter);
+            trie.insert(filter, client);
+        }
+    }
+
+    const char* topics[] = {"iotzoo/picea/esp32/e4:65:b8:b0:45:b4/tm1637_4/7/t32",
+                            "iotzoo/picea/esp32/e4:65:b8:b0:45:b4/tm1637_4/7/x/t33",
+                            "iotzoo/picea/esp32/e4:65:b8:b0:45:b4/tm1637_4/3/t34/a/b",
+                            "iotzoo/picea/esp32/e4:65:b8:b0:45:b4/tm1637_4/3/t34",
+                            "iotzoo/other/esp32/11:22:33:44:55:66/tm1637_4/19/t35",
+                            "iotzoo/picea/esp32/e4:65:b8:b0:45:b4/tm1637_4/7/t35/extra",
+                            "iotzoo/picea"};
+    for (const char* topic : topics)
+    {
+        Matches       linear;
+        InternalTopic published(topic);
+        for (int client = 0; client < Clients; client++)
+        {
+            for (const auto& filter : filters[client])
+            {
+                if (filter.matches(published))
+                {
+                    linear.push_back(client);
+                    break;
+                }
+            }
+        }
+        TEST_ASSERT_TRUE_MESSAGE(match(trie, topic) == linear, topic);
+    }
+}
+
+void test_benchmark_trie_vs_linear_scan()
+{
+    std::vector<std::vector<InternalTopic>> filters(Clients);
+    TopicTrie<int>                          trie;
+    for (int client = 0; client < Clients; client++)
+    {
+        for (int subscription = 0; subscription < Subscriptions; subscription++)
+        {
+            std::string filter = filterOf(client, subscription);
+            filters[client].emplace_back(filter);
+            trie.insert(filter, client);
+        }
+    }
+    InternalTopic published("iotzoo/picea/esp32/e4:65:b8:b0:45:b4/tm1637_4/7/t36");
+
+    const int Publishes = 2000;
+    size_t    hits      = 0;
+    auto      start     = std::chrono::steady_clock::now();
+    for (int i = 0; i < Publishes; i++)
+    {
+        for (int client = 0; client < Clients; client++)
+        {
+            for (const auto& filter : filters[client])
+            {
+                if (filter.matches(published))
+                {
+                    hits++;
+                    break;
+                }
+            }
+        }
+    }
+    auto    linearEnd = std::chrono::steady_clock::now();
+    Matches result;
+    for (int i = 0; i < Publishes; i++)
+    {
+        trie.match(published.str(), result);
+        hits += result.size();
+    }
+    auto trieEnd = std::chrono::steady_clock::now();
+
+    double linearUs = std::chrono::duration<double, std::micro>(linearEnd - start).count() / Publishes;
+    double trieUs   = std::chrono::duration<double, std::micro>(trieEnd - linearEnd).count() / Publishes;
+    char   message[128];
+    snprintf(message, sizeof(message), "%d x %d subscriptions: linear scan %.2f us, trie %.2f us per publish", Clients, Subscriptions,
+             linearUs, trieUs);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL(2 * Publishes, hits);
+    TEST_ASSERT_TRUE(trieUs < linearUs);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_wildcards);
+    RUN_TEST(test_remove);
+    RUN_TEST(test_same_result_as_linear_scan);
+    RUN_TEST(test_benchmark_trie_vs_linear_scan);
+    return UNITY_END();
+}
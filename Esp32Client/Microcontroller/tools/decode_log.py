@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+# --------------------------------------------------------------------------------------------------------------------
+#      ____    ______   _____
+#     /  _/___/_  __/  /__  / ____  ____
+#     / // __ \/ /       / / / __ \/ __ \  P L A Y G R O U N D
+#   _/ // /_/ / /       / /_/ /_/ / /_/ /
+#  /___/\____/_/       /____|____/\____/   (c) 2025 - 2026 Holger Freudenreich under the MIT licence.
+#
+# --------------------------------------------------------------------------------------------------------------------
+# Decodes the records of logBinary() (see include/BinaryLog.hpp) with the firmware.elf of the same build.
+#
+#   pio device monitor | python3 tools/decode_log.py .pio/build/esp32dev/firmware.elf
+#   python3 tools/decode_log.py .pio/build/esp32dev/firmware.elf --raw log.bin   (payload of <base topic>/log)
+#
+# Without --raw, lines starting with "#L " are decoded and all other lines are printed unchanged.
+# --------------------------------------------------------------------------------------------------------------------
+import argparse
+import re
+import struct
+import sys
+
+HEADER_WORDS = 3
+SHF_ALLOC = 0x2
+SHT_PROGBITS = 1
+
+SPEC = re.compile(r"%([-+ #0]*)(\d*|\*)(?:\.(\d*))?(hh|h|ll|l|z|j|t)?([diouxXcsfFeEgGp%])")
+
+
+class Elf:
+    """The allocated sections of a 32 bit little endian ELF file, enough to read the format strings."""
+
+    def __init__(self, path):
+        with open(path, "rb") as file:
+            data = file.read()
+        if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+            raise ValueError(path + " is not a 32 bit little endian ELF file")
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+        self.sections = []
+        for i in range(shnum):
+            _, type, flags, addr, offset, size = struct.unpack_from("<IIIIII", data, shoff + i * shentsize)
+            if type == SHT_PROGBITS and flags & SHF_ALLOC and addr != 0:
+                self.sections.append((addr, data[offset : offset + size]))
+
+    def string(self, address):
+        for start, content in self.sections:
+            if start <= address < start + len(content):
+                end = content.find(b"\0", address - start)
+                return content[address - start : end if end >= 0 else len(content)].decode("utf-8", "replace")
+        return None
+
+
+def format_record(elf, format, arguments):
+    result = []
+    position = 0
+    index = 0
+    for match in SPEC.finditer(format):
+        result.append(format[position : match.start()])
+        position = match.end()
+        flags, width, precision, _, conversion = match.groups()
+        if conversion == "%":
+            result.append("%")
+            continue
+        if index >= len(arguments):
+            result.append(match.group(0))
+            continue
+        word = arguments[index]
+        index += 1
+        spec = "%" + flags + width + ("." + precision if precision is not None else "")
+        if conversion in "fFeEgG":
+            result.append((spec + conversion) % struct.unpack("<f", struct.pack("<I", word))[0])
+        elif conversion in "di":
+            result.append((spec + "d") % (word - (1 << 32) if word & 0x80000000 else word))
+        elif conversion == "s":
+            text = elf.string(word)
+            result.append((spec + "s") % (text if text is not None else "<0x%08x>" % word))
+        elif conversion == "c":
+            result.append((spec + "c") % chr(word & 0xFF))
+        elif conversion == "p":
+            result.append("0x%08x" % word)
+        else:
+            result.append((spec + conversion) % word)
+    result.append(format[position:])
+    return "".join(result)
+
+
+class Decoder:
+    def __init__(self, elf):
+        self.elf = elf
+        self.sequence = None
+
+    def records(self, data):
+        """Splits data into records, a trailing incomplete record is ignored."""
+        offset = 0
+        while offset + HEADER_WORDS * 4 <= len(data):
+            format_address, millis, info = struct.unpack_from("<III", data, offset)
+            count = info >> 24
+            end = offset + (HEADER_WORDS + count) * 4
+            if end > len(data):
+                break
+            arguments = struct.unpack_from("<%dI" % count, data, offset + HEADER_WORDS * 4)
+            yield format_address, millis, info & 0xFFFFFF, arguments
+            offset = end
+
+    def decode(self, data):
+        lines = []
+        for format_address, millis, sequence, arguments in self.records(data):
+            if self.sequence is not None and sequence != self.sequence:
+                lines.append("*** %d record(s) dropped ***" % ((sequence - self.sequence) & 0xFFFFFF))
+            self.sequence = (sequence + 1) & 0xFFFFFF
+            format = self.elf.string(format_address)
+            if format is None:
+                text = "<unknown format 0x%08x> %s" % (format_address, " ".join("0x%08x" % a for a in arguments))
+            else:
+                text = format_record(self.elf, format, arguments)
+            lines.append("[%10u] %s" % (millis, text))
+        return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decodes the binary log of the IotZoo microcontroller.")
+    parser.add_argument("elf", help="firmware.elf of the running build")
+    parser.add_argument("input", nargs="?", help="input file, default stdin")
+    parser.add_argument("--raw", action="store_true", help="input is binary, e.g. the payload of <base topic>/log")
+    args = parser.parse_intermixed_args()
+
+    decoder = Decoder(Elf(args.elf))
+    if args.raw:
+        with open(args.input, "rb") if args.input else sys.stdin.buffer as file:
+            for line in decoder.decode(file.read()):
+                print(line)
+        return
+
+    with open(args.input, "r", errors="replace") if args.input else sys.stdin as file:
+        for line in file:
+            line = line.rstrip("\r\n")
+            if line.startswith("#L "):
+                try:
+                    data = bytes.fromhex(line[3:])
+                except ValueError:
+                    print(line)
+                    continue
+                for text in decoder.decode(data):
+                    print(text)
+            else:
+                print(line)
+            sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()